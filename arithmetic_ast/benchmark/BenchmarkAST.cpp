@@ -0,0 +1,194 @@
+#include "benchmark/BenchmarkUtilities.hpp"
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/FlatExpression.hpp"
+#include "lib/PrintVisitor.hpp"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace ast;
+using namespace ast::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// The recursive tree walks only see deep chains up to this size
+constexpr int64_t maxChainNodes = 1 << 14;
+constexpr int64_t maxNodes = 1 << 20;
+//---------------------------------------------------------------------------
+enum Shape : int64_t { Random,
+                       DeepChain,
+                       Balanced,
+                       PowerHeavy };
+//---------------------------------------------------------------------------
+// Combine the nodes pairwise until one is left, alternating Add and Multiply per level
+unique_ptr<ASTNode> combineBalanced(vector<unique_ptr<ASTNode>> level) {
+    for (bool add = true; level.size() > 1; add = !add) {
+        vector<unique_ptr<ASTNode>> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            if (add) next.push_back(make_unique<Add>(std::move(level[i]), std::move(level[i + 1])));
+            else next.push_back(make_unique<Multiply>(std::move(level[i]), std::move(level[i + 1])));
+        }
+        if (level.size() % 2) next.push_back(std::move(level.back()));
+        level = std::move(next);
+    }
+    return std::move(level.front());
+}
+//---------------------------------------------------------------------------
+// ((P0 + P1) + P2) + ...: left-deep chain with n nodes
+unique_ptr<ASTNode> deepChain(size_t n) {
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (size_t i = 1; i < n / 2; ++i) node = make_unique<Add>(std::move(node), make_unique<Parameter>(i % 4));
+    return node;
+}
+//---------------------------------------------------------------------------
+// Complete tree with n nodes over parameters only
+unique_ptr<ASTNode> balancedTree(size_t n) {
+    vector<unique_ptr<ASTNode>> leaves;
+    for (size_t i = 0; i < max<size_t>(1, n / 2); ++i) leaves.push_back(make_unique<Parameter>(i % 4));
+    return combineBalanced(std::move(leaves));
+}
+//---------------------------------------------------------------------------
+// Random mix of all node types with n nodes. The constants 0 and 1
+// give optimize() something to fold.
+unique_ptr<ASTNode> randomTree(size_t n, mt19937& rng) {
+    if (n <= 1) {
+        switch (rng() % 6) {
+            case 0: return make_unique<Constant>(0.0);
+            case 1: return make_unique<Constant>(1.0);
+            case 2: return make_unique<Constant>(2.5);
+            default: return make_unique<Parameter>(rng() % 4);
+        }
+    }
+    if (n == 2 || rng() % 8 == 0) {
+        if (rng() % 2) return make_unique<UnaryMinus>(randomTree(n - 1, rng));
+        return make_unique<UnaryPlus>(randomTree(n - 1, rng));
+    }
+    size_t left = 1 + rng() % (n - 2);
+    auto l = randomTree(left, rng);
+    auto r = randomTree(n - 1 - left, rng);
+    switch (rng() % 5) {
+        case 0: return make_unique<Add>(std::move(l), std::move(r));
+        case 1: return make_unique<Subtract>(std::move(l), std::move(r));
+        case 2: return make_unique<Multiply>(std::move(l), std::move(r));
+        case 3: return make_unique<Divide>(std::move(l), std::move(r));
+        default: return make_unique<Power>(std::move(l), std::move(r));
+    }
+}
+//---------------------------------------------------------------------------
+// Balanced product of factors (Pi + 1) ^ e. Most exponents are 2, 3 or 0.5,
+// so nearly every factor stays a std::pow call after optimization.
+unique_ptr<ASTNode> powerHeavyTree(size_t n, mt19937& rng) {
+    static constexpr double exponents[] = {0.5, 1.0, 2.0, 3.0, 2.0, 3.0, 0.5, 2.0};
+    vector<unique_ptr<ASTNode>> factors;
+    for (size_t i = 0; i < max<size_t>(1, n / 6); ++i) {
+        auto base = make_unique<Add>(make_unique<Parameter>(rng() % 4), make_unique<Constant>(1.0));
+        factors.push_back(make_unique<Power>(std::move(base), make_unique<Constant>(exponents[rng() % 8])));
+    }
+    return combineBalanced(std::move(factors));
+}
+//---------------------------------------------------------------------------
+unique_ptr<ASTNode> makeTree(const benchmark::State& state) {
+    auto n = static_cast<size_t>(state.range(1));
+    mt19937 rng(42);
+    switch (state.range(0)) {
+        case DeepChain: return deepChain(n);
+        case Balanced: return balancedTree(n);
+        case PowerHeavy: return powerHeavyTree(n, rng);
+        default: return randomTree(n, rng);
+    }
+}
+//---------------------------------------------------------------------------
+size_t countNodes(const ASTNode& root) { return flat::Expression(root).size(); }
+//---------------------------------------------------------------------------
+void reportNodes(benchmark::State& state, size_t nodes) {
+    state.counters["nodes"] = static_cast<double>(nodes);
+    state.counters["nodes_per_second"] = benchmark::Counter(static_cast<double>(nodes), benchmark::Counter::kIsIterationInvariantRate);
+}
+//---------------------------------------------------------------------------
+void RecursiveArguments(benchmark::internal::Benchmark* b) {
+    ShapeArguments(b, {Random, DeepChain, Balanced, PowerHeavy}, 1 << 8, [](int64_t shape) { return shape == DeepChain ? maxChainNodes : maxNodes; });
+}
+void AllArguments(benchmark::internal::Benchmark* b) {
+    ShapeArguments(b, {Random, DeepChain, Balanced, PowerHeavy}, 1 << 8, [](int64_t) { return maxNodes; });
+}
+//---------------------------------------------------------------------------
+void BenchmarkBuild(benchmark::State& state) {
+    size_t nodes = countNodes(*makeTree(state));
+    for (auto _ : state) {
+        auto tree = makeTree(state);
+        state.PauseTiming();
+        tree.reset();
+        state.ResumeTiming();
+    }
+    reportNodes(state, nodes);
+}
+//---------------------------------------------------------------------------
+void BenchmarkOptimize(benchmark::State& state) {
+    size_t nodes = countNodes(*makeTree(state));
+    size_t optimized = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tree = makeTree(state);
+        state.ResumeTiming();
+        tree->optimize(tree);
+        state.PauseTiming();
+        optimized = countNodes(*tree);
+        tree.reset();
+        state.ResumeTiming();
+    }
+    reportNodes(state, nodes);
+    state.counters["optimized_nodes"] = static_cast<double>(optimized);
+}
+//---------------------------------------------------------------------------
+void BenchmarkEvaluate(benchmark::State& state) {
+    auto tree = makeTree(state);
+    vector<double> params{1.0, 2.0, 3.0, 4.0};
+    EvaluationContext context(params);
+    context.validate(*tree);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree->evaluate(context));
+    reportNodes(state, countNodes(*tree));
+}
+//---------------------------------------------------------------------------
+// Same as BenchmarkEvaluate after optimize(); nodes_per_second still counts
+// the nodes of the original tree, so the two are directly comparable
+void BenchmarkEvaluateOptimized(benchmark::State& state) {
+    auto tree = makeTree(state);
+    size_t nodes = countNodes(*tree);
+    tree->optimize(tree);
+    vector<double> params{1.0, 2.0, 3.0, 4.0};
+    EvaluationContext context(params);
+    context.validate(*tree);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree->evaluate(context));
+    reportNodes(state, nodes);
+    state.counters["optimized_nodes"] = static_cast<double>(countNodes(*tree));
+}
+//---------------------------------------------------------------------------
+void BenchmarkPrint(benchmark::State& state) {
+    auto tree = makeTree(state);
+    NullBuffer sink;
+    auto* sbuf = cout.rdbuf(&sink);
+    PrintVisitor visitor;
+    for (auto _ : state)
+        tree->accept(visitor);
+    cout.rdbuf(sbuf);
+    reportNodes(state, countNodes(*tree));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkBuild)->Apply(AllArguments);
+BENCHMARK(BenchmarkOptimize)->Apply(RecursiveArguments);
+BENCHMARK(BenchmarkEvaluate)->Apply(RecursiveArguments);
+BENCHMARK(BenchmarkEvaluateOptimized)->Apply(RecursiveArguments);
+BENCHMARK(BenchmarkPrint)->Apply(RecursiveArguments);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
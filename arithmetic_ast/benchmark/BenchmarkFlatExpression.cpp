@@ -0,0 +1,102 @@
+#include "benchmark/BenchmarkUtilities.hpp"
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/FlatExpression.hpp"
+#include "lib/PrintVisitor.hpp"
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace ast;
+using namespace ast::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Random tree with n binary nodes over four parameters and a few constants
+unique_ptr<ASTNode> randomTree(size_t n, mt19937& rng) {
+    if (n == 0) {
+        if (rng() % 4 == 0) return make_unique<Constant>(1.5);
+        return make_unique<Parameter>(rng() % 4);
+    }
+    size_t left = rng() % n;
+    auto l = randomTree(left, rng);
+    auto r = randomTree(n - 1 - left, rng);
+    switch (rng() % 4) {
+        case 0: return make_unique<Add>(std::move(l), std::move(r));
+        case 1: return make_unique<Subtract>(std::move(l), std::move(r));
+        case 2: return make_unique<Multiply>(std::move(l), std::move(r));
+        default: return make_unique<Divide>(std::move(l), std::move(r));
+    }
+}
+//---------------------------------------------------------------------------
+unique_ptr<ASTNode> makeTree(const benchmark::State& state) {
+    mt19937 rng(42);
+    return randomTree(static_cast<size_t>(state.range(0)), rng);
+}
+//---------------------------------------------------------------------------
+void BenchmarkEvaluateTree(benchmark::State& state) {
+    auto tree = makeTree(state);
+    vector<double> params{1.0, 2.0, 3.0, 4.0};
+    EvaluationContext context(params);
+    context.validate(*tree);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree->evaluate(context));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkEvaluateFlat(benchmark::State& state) {
+    auto tree = makeTree(state);
+    flat::Expression expression(*tree);
+    vector<double> params{1.0, 2.0, 3.0, 4.0};
+    EvaluationContext context(params);
+    context.validate(*tree);
+    vector<double> scratch;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(expression.evaluate(context, scratch));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkVisitTree(benchmark::State& state) {
+    auto tree = makeTree(state);
+    NullBuffer sink;
+    auto* sbuf = cout.rdbuf(&sink);
+    PrintVisitor visitor;
+    for (auto _ : state)
+        tree->accept(visitor);
+    cout.rdbuf(sbuf);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkVisitFlat(benchmark::State& state) {
+    auto tree = makeTree(state);
+    flat::Expression expression(*tree);
+    NullBuffer sink;
+    ostream out(&sink);
+    for (auto _ : state)
+        expression.print(out);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkConvert(benchmark::State& state) {
+    auto tree = makeTree(state);
+    for (auto _ : state) {
+        flat::Expression expression(*tree);
+        benchmark::DoNotOptimize(expression.toTree());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkEvaluateTree)->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BenchmarkEvaluateFlat)->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BenchmarkVisitTree)->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BenchmarkVisitFlat)->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BenchmarkConvert)->RangeMultiplier(8)->Range(64, 1 << 18);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+#include "benchmark/BenchmarkUtilities.hpp"
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/IterativeTraversal.hpp"
+#include "lib/PrintVisitor.hpp"
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace ast;
+using namespace ast::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Recursive walks are only run up to this depth to stay clear of the stack limit
+constexpr int64_t maxRecursiveDepth = 1 << 14;
+//---------------------------------------------------------------------------
+enum Shape : int64_t { Degenerate,
+                       Balanced };
+//---------------------------------------------------------------------------
+// Left-deep chain of n Add nodes
+unique_ptr<ASTNode> degenerateTree(size_t n) {
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (size_t i = 0; i < n; ++i) node = make_unique<Add>(std::move(node), make_unique<Parameter>((i + 1) % 4));
+    return node;
+}
+//---------------------------------------------------------------------------
+// Complete tree of n - 1 binary nodes over n leaves (n is a power of two)
+unique_ptr<ASTNode> balancedTree(size_t n) {
+    vector<unique_ptr<ASTNode>> level;
+    for (size_t i = 0; i < n; ++i) level.push_back(make_unique<Parameter>(i % 4));
+    while (level.size() > 1) {
+        vector<unique_ptr<ASTNode>> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            if (i % 4 == 0) next.push_back(make_unique<Add>(std::move(level[i]), std::move(level[i + 1])));
+            else next.push_back(make_unique<Multiply>(std::move(level[i]), std::move(level[i + 1])));
+        }
+        level = std::move(next);
+    }
+    return std::move(level.front());
+}
+//---------------------------------------------------------------------------
+unique_ptr<ASTNode> makeTree(const benchmark::State& state) {
+    auto n = static_cast<size_t>(state.range(1));
+    return state.range(0) == Degenerate ? degenerateTree(n) : balancedTree(n);
+}
+//---------------------------------------------------------------------------
+void RecursiveArguments(benchmark::internal::Benchmark* b) {
+    ShapeArguments(b, {Degenerate, Balanced}, 1 << 10, [](int64_t) { return maxRecursiveDepth; });
+}
+void IterativeArguments(benchmark::internal::Benchmark* b) {
+    ShapeArguments(b, {Degenerate, Balanced}, 1 << 10, [](int64_t) -> int64_t { return 1 << 20; });
+}
+//---------------------------------------------------------------------------
+void BenchmarkEvaluateRecursive(benchmark::State& state) {
+    auto tree = makeTree(state);
+    vector<double> params{1.0, 2.0, 3.0, 4.0};
+    EvaluationContext context(params);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree->evaluate(context));
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+void BenchmarkEvaluateIterative(benchmark::State& state) {
+    auto tree = makeTree(state);
+    vector<double> params{1.0, 2.0, 3.0, 4.0};
+    EvaluationContext context(params);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(evaluateIteratively(*tree, context));
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+void BenchmarkPrintRecursive(benchmark::State& state) {
+    auto tree = makeTree(state);
+    NullBuffer sink;
+    auto* sbuf = cout.rdbuf(&sink);
+    PrintVisitor visitor;
+    for (auto _ : state)
+        tree->accept(visitor);
+    cout.rdbuf(sbuf);
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+void BenchmarkPrintIterative(benchmark::State& state) {
+    auto tree = makeTree(state);
+    NullBuffer sink;
+    ostream out(&sink);
+    for (auto _ : state)
+        printIteratively(*tree, out);
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+void BenchmarkOptimizeRecursive(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tree = makeTree(state);
+        state.ResumeTiming();
+        tree->optimize(tree);
+        state.PauseTiming();
+        tree.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+void BenchmarkOptimizeIterative(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tree = makeTree(state);
+        state.ResumeTiming();
+        optimizeIteratively(tree);
+        state.PauseTiming();
+        tree.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+void BenchmarkDestroy(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tree = makeTree(state);
+        state.ResumeTiming();
+        tree.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkEvaluateRecursive)->Apply(RecursiveArguments);
+BENCHMARK(BenchmarkEvaluateIterative)->Apply(IterativeArguments);
+BENCHMARK(BenchmarkPrintRecursive)->Apply(RecursiveArguments);
+BENCHMARK(BenchmarkPrintIterative)->Apply(IterativeArguments);
+BENCHMARK(BenchmarkOptimizeRecursive)->Apply(RecursiveArguments);
+BENCHMARK(BenchmarkOptimizeIterative)->Apply(IterativeArguments);
+BENCHMARK(BenchmarkDestroy)->Apply(IterativeArguments);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,32 @@
+#ifndef H_benchmark_BenchmarkUtilities
+#define H_benchmark_BenchmarkUtilities
+//---------------------------------------------------------------------------
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <streambuf>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+// Helpers shared by the benchmarks in this directory
+//---------------------------------------------------------------------------
+namespace ast::benchmarks {
+
+// Discards everything written to it, so that printing is timed without I/O
+class NullBuffer : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// Register the arguments {shape, n} for every shape, with n growing by a
+// factor of four from minNodes up to maxNodes(shape)
+inline void ShapeArguments(benchmark::internal::Benchmark* b, std::initializer_list<int64_t> shapes, int64_t minNodes, const std::function<int64_t(int64_t)>& maxNodes) {
+    for (int64_t shape : shapes)
+        for (int64_t n = minNodes; n <= maxNodes(shape); n <<= 2)
+            b->Args({shape, n});
+    b->ArgNames({"shape", "n"});
+}
+
+} // namespace ast::benchmarks
+//---------------------------------------------------------------------------
+#endif
@@ -1,11 +1,45 @@
 #include "lib/AST.hpp"
 #include "lib/EvaluationContext.hpp"
 #include "lib/ASTVisitor.hpp"
+#include <algorithm>
 #include <cmath>
 #include <type_traits>
+#include <vector>
 
 namespace ast {
 
+namespace {
+
+bool isLeaf(const std::unique_ptr<ASTNode>& node) {
+    return !node || node->getType() == ASTNode::Type::Constant || node->getType() == ASTNode::Type::Parameter;
+}
+
+// Move an input that has inputs itself onto pending; leaves are destroyed with their parent
+void detach(std::unique_ptr<ASTNode>& input, std::vector<std::unique_ptr<ASTNode>>& pending) {
+    if (!isLeaf(input)) pending.push_back(std::move(input));
+}
+
+// Destroy the subtrees on pending with an explicit stack. Every node is
+// stripped of its inputs before it dies, so its destructor does not recurse.
+void destroy(std::vector<std::unique_ptr<ASTNode>>& pending) {
+    while (!pending.empty()) {
+        std::unique_ptr<ASTNode> node = std::move(pending.back());
+        pending.pop_back();
+        switch (node->getType()) {
+            case ASTNode::Type::UnaryPlus: detach(static_cast<UnaryPlus&>(*node).getMutableInput(), pending); break;
+            case ASTNode::Type::UnaryMinus: detach(static_cast<UnaryMinus&>(*node).getMutableInput(), pending); break;
+            default: {
+                auto& bin = static_cast<BinaryASTNode&>(*node);
+                detach(bin.getMutableLeft(), pending);
+                detach(bin.getMutableRight(), pending);
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
 // --- Constant -------------------------------------------------------------
 Constant::Constant(double v) : value(v) {}
 ASTNode::Type Constant::getType() const { return ASTNode::Type::Constant; }
@@ -24,6 +58,11 @@ size_t Parameter::getIndex() const { return m_index; }
 
 // --- UnaryPlus -----------------------------------------------------------
 UnaryPlus::UnaryPlus(std::unique_ptr<ASTNode> child) : childNode(std::move(child)) {}
+UnaryPlus::~UnaryPlus() {
+    std::vector<std::unique_ptr<ASTNode>> pending;
+    detach(childNode, pending);
+    destroy(pending);
+}
 ASTNode::Type UnaryPlus::getType() const { return ASTNode::Type::UnaryPlus; }
 double UnaryPlus::evaluate(EvaluationContext& ctx) { return childNode->evaluate(ctx); }
 void UnaryPlus::accept(ASTVisitor& visitor) { visitor.visit(*this); }
@@ -32,23 +71,32 @@ ASTNode& UnaryPlus::getInput() { return *childNode; }
 const ASTNode& UnaryPlus::getInput() const { return *childNode; }
 void UnaryPlus::optimize(std::unique_ptr<ASTNode>& thisRef) {
     if (!childNode) return;
+    if (collapse(thisRef)) return;
+
+    // Otherwise optimize child in-place
+    childNode->optimize(childNode);
+}
 
+bool UnaryPlus::collapse(std::unique_ptr<ASTNode>& thisRef) {
     // Flatten +(+x) -> +x and +const/param -> child (preserve pointer identity)
     if (childNode->getType() == ASTNode::Type::UnaryPlus
         || childNode->getType() == ASTNode::Type::Constant
         || childNode->getType() == ASTNode::Type::Parameter) {
         thisRef = std::move(childNode);
-        return;
+        return true;
     }
-
-    // Otherwise optimize child in-place
-    childNode->optimize(childNode);
+    return false;
 }
 
 // --- UnaryMinus ----------------------------------------------------------
 UnaryMinus::UnaryMinus(std::unique_ptr<ASTNode> child) : childNode(std::move(child)) {}
+UnaryMinus::~UnaryMinus() {
+    std::vector<std::unique_ptr<ASTNode>> pending;
+    detach(childNode, pending);
+    destroy(pending);
+}
 ASTNode::Type UnaryMinus::getType() const { return ASTNode::Type::UnaryMinus; }
-double UnaryMinus::evaluate(EvaluationContext& ctx) { return -childNode->evaluate(ctx); }
+double UnaryMinus::evaluate(EvaluationContext& ctx) { return applyOp(Type::UnaryMinus, childNode->evaluate(ctx), 0.0); }
 void UnaryMinus::accept(ASTVisitor& visitor) { visitor.visit(*this); }
 std::unique_ptr<ASTNode>& UnaryMinus::getMutableInput() { return childNode; }
 ASTNode& UnaryMinus::getInput() { return *childNode; }
@@ -56,7 +104,10 @@ const ASTNode& UnaryMinus::getInput() const { return *childNode; }
 
 void UnaryMinus::optimize(std::unique_ptr<ASTNode>& thisRef) {
     if (childNode) childNode->optimize(childNode);
+    simplify(thisRef);
+}
 
+void UnaryMinus::simplify(std::unique_ptr<ASTNode>& thisRef) {
     if (!childNode) return;
 
     // -const -> const(-v)
@@ -98,8 +149,17 @@ void UnaryMinus::optimize(std::unique_ptr<ASTNode>& thisRef) {
 BinaryASTNode::BinaryASTNode(std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r)
     : leftNode(std::move(l)), rightNode(std::move(r)) {}
 
+BinaryASTNode::~BinaryASTNode() {
+    std::vector<std::unique_ptr<ASTNode>> pending;
+    detach(leftNode, pending);
+    detach(rightNode, pending);
+    destroy(pending);
+}
+
 ASTNode& BinaryASTNode::getLeft() { return *leftNode; }
 ASTNode& BinaryASTNode::getRight() { return *rightNode; }
+const ASTNode& BinaryASTNode::getLeft() const { return *leftNode; }
+const ASTNode& BinaryASTNode::getRight() const { return *rightNode; }
 std::unique_ptr<ASTNode> BinaryASTNode::releaseLeft() { return std::move(leftNode); }
 std::unique_ptr<ASTNode> BinaryASTNode::releaseRight() { return std::move(rightNode); }
 std::unique_ptr<ASTNode>& BinaryASTNode::getMutableLeft() { return leftNode; }
@@ -108,13 +168,16 @@ std::unique_ptr<ASTNode>& BinaryASTNode::getMutableRight() { return rightNode; }
 // --- Add -----------------------------------------------------------------
 Add::Add(std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r) : BinaryASTNode(std::move(l), std::move(r)) {}
 ASTNode::Type Add::getType() const { return ASTNode::Type::Add; }
-double Add::evaluate(EvaluationContext& ctx) { return getLeft().evaluate(ctx) + getRight().evaluate(ctx); }
+double Add::evaluate(EvaluationContext& ctx) { return applyOp(Type::Add, getLeft().evaluate(ctx), getRight().evaluate(ctx)); }
 void Add::accept(ASTVisitor& visitor) { visitor.visit(*this); }
 
 void Add::optimize(std::unique_ptr<ASTNode>& thisRef) {
     if (getMutableLeft()) getMutableLeft()->optimize(getMutableLeft());
     if (getMutableRight()) getMutableRight()->optimize(getMutableRight());
+    simplify(thisRef);
+}
 
+void Add::simplify(std::unique_ptr<ASTNode>& thisRef) {
     // both constants
     if (getLeft().getType() == ASTNode::Type::Constant && getRight().getType() == ASTNode::Type::Constant) {
         double a = static_cast<Constant*>(&getLeft())->getValue();
@@ -155,13 +218,16 @@ void Add::optimize(std::unique_ptr<ASTNode>& thisRef) {
 // --- Subtract ------------------------------------------------------------
 Subtract::Subtract(std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r) : BinaryASTNode(std::move(l), std::move(r)) {}
 ASTNode::Type Subtract::getType() const { return ASTNode::Type::Subtract; }
-double Subtract::evaluate(EvaluationContext& ctx) { return getLeft().evaluate(ctx) - getRight().evaluate(ctx); }
+double Subtract::evaluate(EvaluationContext& ctx) { return applyOp(Type::Subtract, getLeft().evaluate(ctx), getRight().evaluate(ctx)); }
 void Subtract::accept(ASTVisitor& visitor) { visitor.visit(*this); }
 
 void Subtract::optimize(std::unique_ptr<ASTNode>& thisRef) {
     if (getMutableLeft()) getMutableLeft()->optimize(getMutableLeft());
     if (getMutableRight()) getMutableRight()->optimize(getMutableRight());
+    simplify(thisRef);
+}
 
+void Subtract::simplify(std::unique_ptr<ASTNode>& thisRef) {
     if (getLeft().getType() == ASTNode::Type::Constant && getRight().getType() == ASTNode::Type::Constant) {
         double a = static_cast<Constant*>(&getLeft())->getValue();
         double b = static_cast<Constant*>(&getRight())->getValue();
@@ -194,13 +260,16 @@ void Subtract::optimize(std::unique_ptr<ASTNode>& thisRef) {
 // --- Multiply ------------------------------------------------------------
 Multiply::Multiply(std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r) : BinaryASTNode(std::move(l), std::move(r)) {}
 ASTNode::Type Multiply::getType() const { return ASTNode::Type::Multiply; }
-double Multiply::evaluate(EvaluationContext& ctx) { return getLeft().evaluate(ctx) * getRight().evaluate(ctx); }
+double Multiply::evaluate(EvaluationContext& ctx) { return applyOp(Type::Multiply, getLeft().evaluate(ctx), getRight().evaluate(ctx)); }
 void Multiply::accept(ASTVisitor& visitor) { visitor.visit(*this); }
 
 void Multiply::optimize(std::unique_ptr<ASTNode>& thisRef) {
     if (getMutableLeft()) getMutableLeft()->optimize(getMutableLeft());
     if (getMutableRight()) getMutableRight()->optimize(getMutableRight());
+    simplify(thisRef);
+}
 
+void Multiply::simplify(std::unique_ptr<ASTNode>& thisRef) {
     if (getLeft().getType() == ASTNode::Type::Constant && getRight().getType() == ASTNode::Type::Constant) {
         double a = static_cast<Constant*>(&getLeft())->getValue();
         double b = static_cast<Constant*>(&getRight())->getValue();
@@ -233,16 +302,20 @@ void Multiply::optimize(std::unique_ptr<ASTNode>& thisRef) {
 Divide::Divide(std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r) : BinaryASTNode(std::move(l), std::move(r)) {}
 ASTNode::Type Divide::getType() const { return ASTNode::Type::Divide; }
 double Divide::evaluate(EvaluationContext& ctx) {
+    // The left input is not evaluated for a zero divisor
     double rv = getRight().evaluate(ctx);
-    if (rv == 0.0) return 0.0; // simplistic
-    return getLeft().evaluate(ctx) / rv;
+    if (rv == 0.0) return 0.0;
+    return applyOp(Type::Divide, getLeft().evaluate(ctx), rv);
 }
 void Divide::accept(ASTVisitor& visitor) { visitor.visit(*this); }
 
 void Divide::optimize(std::unique_ptr<ASTNode>& thisRef) {
     if (getMutableLeft()) getMutableLeft()->optimize(getMutableLeft());
     if (getMutableRight()) getMutableRight()->optimize(getMutableRight());
+    simplify(thisRef);
+}
 
+void Divide::simplify(std::unique_ptr<ASTNode>& thisRef) {
     // 0 / x -> 0 (even if x not known)
     if (getLeft().getType() == ASTNode::Type::Constant) {
         double a = static_cast<Constant*>(&getLeft())->getValue();
@@ -299,13 +372,16 @@ void Divide::optimize(std::unique_ptr<ASTNode>& thisRef) {
 // --- Power ---------------------------------------------------------------
 Power::Power(std::unique_ptr<ASTNode> base, std::unique_ptr<ASTNode> exp) : BinaryASTNode(std::move(base), std::move(exp)) {}
 ASTNode::Type Power::getType() const { return ASTNode::Type::Power; }
-double Power::evaluate(EvaluationContext& ctx) { return std::pow(getLeft().evaluate(ctx), getRight().evaluate(ctx)); }
+double Power::evaluate(EvaluationContext& ctx) { return applyOp(Type::Power, getLeft().evaluate(ctx), getRight().evaluate(ctx)); }
 void Power::accept(ASTVisitor& visitor) { visitor.visit(*this); }
 
 void Power::optimize(std::unique_ptr<ASTNode>& thisRef) {
     if (getMutableLeft()) getMutableLeft()->optimize(getMutableLeft());
     if (getMutableRight()) getMutableRight()->optimize(getMutableRight());
+    simplify(thisRef);
+}
 
+void Power::simplify(std::unique_ptr<ASTNode>& thisRef) {
     // both constants
     if (getLeft().getType() == ASTNode::Type::Constant && getRight().getType() == ASTNode::Type::Constant) {
         double a = static_cast<Constant*>(&getLeft())->getValue();
@@ -331,5 +407,36 @@ void Power::optimize(std::unique_ptr<ASTNode>& thisRef) {
 
     // otherwise keep as-is (children already optimized)
 }
+
+// --- Analysis ------------------------------------------------------------
+size_t requiredParameterCount(const ASTNode& root) {
+    // Explicit stack, so that degenerate trees do not overflow the call stack
+    size_t count = 0;
+    std::vector<const ASTNode*> pending{&root};
+    while (!pending.empty()) {
+        const ASTNode* node = pending.back();
+        pending.pop_back();
+        switch (node->getType()) {
+            case ASTNode::Type::Constant:
+                break;
+            case ASTNode::Type::Parameter:
+                count = std::max(count, static_cast<const Parameter*>(node)->getIndex() + 1);
+                break;
+            case ASTNode::Type::UnaryPlus:
+                pending.push_back(&static_cast<const UnaryPlus*>(node)->getInput());
+                break;
+            case ASTNode::Type::UnaryMinus:
+                pending.push_back(&static_cast<const UnaryMinus*>(node)->getInput());
+                break;
+            default: {
+                auto bin = static_cast<const BinaryASTNode*>(node);
+                pending.push_back(&bin->getLeft());
+                pending.push_back(&bin->getRight());
+                break;
+            }
+        }
+    }
+    return count;
+}
 //---------------------------------------------------------------------------
 } // namespace ast
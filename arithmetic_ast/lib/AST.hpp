@@ -4,6 +4,7 @@
 #include "lib/ASTVisitor.hpp"
 #include <cmath>
 #include <memory>
+#include <vector>
 
 namespace ast {
 
@@ -22,6 +23,8 @@ public:
     virtual Type getType() const = 0;
     virtual double evaluate(EvaluationContext& ctx) = 0;
     virtual void optimize(std::unique_ptr<ASTNode>& thisRef) = 0;
+    // Apply the rewrite rules of this node only, assuming its inputs are already optimized
+    virtual void simplify(std::unique_ptr<ASTNode>& thisRef) { (void)thisRef; }
     virtual void accept(ASTVisitor& visitor) = 0;
 };
 
@@ -29,9 +32,12 @@ public:
 class UnaryPlus : public ASTNode {
 public:
     UnaryPlus(std::unique_ptr<ASTNode> child);
+    ~UnaryPlus() override;
     Type getType() const override;
     double evaluate(EvaluationContext& ctx) override;
     void optimize(std::unique_ptr<ASTNode>& thisRef) override;
+    // Replace +(+x), +const and +param by the input; runs before the input is optimized
+    bool collapse(std::unique_ptr<ASTNode>& thisRef);
     void accept(ASTVisitor& visitor) override;
     std::unique_ptr<ASTNode>& getMutableInput();
     ASTNode& getInput();
@@ -44,9 +50,11 @@ private:
 class UnaryMinus : public ASTNode {
 public:
     UnaryMinus(std::unique_ptr<ASTNode> child);
+    ~UnaryMinus() override;
     Type getType() const override;
     double evaluate(EvaluationContext& ctx) override;
     void optimize(std::unique_ptr<ASTNode>& thisRef) override;
+    void simplify(std::unique_ptr<ASTNode>& thisRef) override;
     void accept(ASTVisitor& visitor) override;
     std::unique_ptr<ASTNode>& getMutableInput();
     ASTNode& getInput();
@@ -59,8 +67,11 @@ private:
 class BinaryASTNode : public ASTNode {
 public:
     BinaryASTNode(std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r);
+    ~BinaryASTNode() override;
     ASTNode& getLeft();
     ASTNode& getRight();
+    const ASTNode& getLeft() const;
+    const ASTNode& getRight() const;
     std::unique_ptr<ASTNode> releaseLeft();
     std::unique_ptr<ASTNode> releaseRight();
     std::unique_ptr<ASTNode>& getMutableLeft();
@@ -77,6 +88,7 @@ public:
     Type getType() const override;
     double evaluate(EvaluationContext& ctx) override;
     void optimize(std::unique_ptr<ASTNode>& thisRef) override;
+    void simplify(std::unique_ptr<ASTNode>& thisRef) override;
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -86,6 +98,7 @@ public:
     Type getType() const override;
     double evaluate(EvaluationContext& ctx) override;
     void optimize(std::unique_ptr<ASTNode>& thisRef) override;
+    void simplify(std::unique_ptr<ASTNode>& thisRef) override;
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -95,6 +108,7 @@ public:
     Type getType() const override;
     double evaluate(EvaluationContext& ctx) override;
     void optimize(std::unique_ptr<ASTNode>& thisRef) override;
+    void simplify(std::unique_ptr<ASTNode>& thisRef) override;
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -104,6 +118,7 @@ public:
     Type getType() const override;
     double evaluate(EvaluationContext& ctx) override;
     void optimize(std::unique_ptr<ASTNode>& thisRef) override;
+    void simplify(std::unique_ptr<ASTNode>& thisRef) override;
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -113,6 +128,7 @@ public:
     Type getType() const override;
     double evaluate(EvaluationContext& ctx) override;
     void optimize(std::unique_ptr<ASTNode>& thisRef) override;
+    void simplify(std::unique_ptr<ASTNode>& thisRef) override;
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -142,5 +158,23 @@ private:
     size_t m_index;
 };
 
+// Number of parameters an expression reads (largest Parameter index + 1)
+size_t requiredParameterCount(const ASTNode& root);
+
+// Value of an inner node of the given type from the values a and b of its
+// inputs (b is ignored by unary nodes). This is what evaluate() computes; every
+// evaluator that combines input values itself goes through here.
+inline double applyOp(ASTNode::Type type, double a, double b) {
+    switch (type) {
+        case ASTNode::Type::UnaryPlus: return a;
+        case ASTNode::Type::UnaryMinus: return -a;
+        case ASTNode::Type::Add: return a + b;
+        case ASTNode::Type::Subtract: return a - b;
+        case ASTNode::Type::Multiply: return a * b;
+        case ASTNode::Type::Divide: return b == 0.0 ? 0.0 : a / b; // simplistic
+        default: return std::pow(a, b);
+    }
+}
+
 } // namespace ast
 #endif
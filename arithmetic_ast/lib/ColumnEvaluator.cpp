@@ -0,0 +1,130 @@
+#include "lib/ColumnEvaluator.hpp"
+#include <algorithm>
+#include <bit>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+//---------------------------------------------------------------------------
+namespace ast {
+
+static_assert(std::endian::native == std::endian::little, "Column files are mapped as native doubles");
+
+// --- MappedColumn --------------------------------------------------------
+MappedColumn::MappedColumn(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size % sizeof(double) != 0) {
+        close(fd);
+        throw std::runtime_error("Not a column file: " + path);
+    }
+    length = static_cast<size_t>(st.st_size);
+    if (length) {
+        mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            close(fd);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        // Columns are read front to back exactly once
+        madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+    close(fd);
+}
+
+MappedColumn::~MappedColumn() {
+    if (mapping) munmap(mapping, length);
+}
+
+MappedColumn::MappedColumn(MappedColumn&& other) noexcept
+    : mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)), released(std::exchange(other.released, 0)) {}
+
+MappedColumn& MappedColumn::operator=(MappedColumn&& other) noexcept {
+    if (this != &other) {
+        if (mapping) munmap(mapping, length);
+        mapping = std::exchange(other.mapping, nullptr);
+        length = std::exchange(other.length, 0);
+        released = std::exchange(other.released, 0);
+    }
+    return *this;
+}
+
+size_t MappedColumn::size() const { return length / sizeof(double); }
+
+const double* MappedColumn::data() const { return static_cast<const double*>(mapping); }
+
+void MappedColumn::release(size_t rows) {
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t end = std::min(rows * sizeof(double), length) / pageSize * pageSize;
+    if (end <= released) return;
+    madvise(static_cast<char*>(mapping) + released, end - released, MADV_DONTNEED);
+    released = end;
+}
+
+// --- ColumnEvaluator -----------------------------------------------------
+ColumnEvaluator::ColumnEvaluator(const ASTNode& root, size_t blockRows)
+    : expression(root), parameterCount(requiredParameterCount(root)), blockRows(std::max<size_t>(1, blockRows)) {}
+
+size_t ColumnEvaluator::run(const std::vector<std::string>& columnPaths, const std::string& outputPath) {
+    if (columnPaths.size() < parameterCount) throw std::out_of_range("Not enough columns for the expression");
+    if (columnPaths.empty()) throw std::out_of_range("At least one column is needed to know the number of rows");
+    std::vector<MappedColumn> columns;
+    for (auto& path : columnPaths) {
+        columns.emplace_back(path);
+        if (columns.back().size() != columns.front().size()) throw std::runtime_error("Column " + path + " has a different number of rows");
+    }
+    size_t numRows = columns.front().size();
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot open " + outputPath + " for writing");
+
+    // inputs[i] points at the values of node i for the current block: into a
+    // mapped column for Parameter nodes, into scratch for all others
+    scratch.resize(expression.size() * blockRows);
+    std::vector<const double*> inputs(expression.size());
+    for (uint32_t i = 0; i < expression.size(); ++i) {
+        double* block = scratch.data() + i * blockRows;
+        inputs[i] = block;
+        if (auto* constant = std::get_if<flat::Constant>(&expression[i])) std::fill(block, block + blockRows, constant->value);
+    }
+
+    for (size_t begin = 0; begin < numRows; begin += blockRows) {
+        size_t count = std::min(blockRows, numRows - begin);
+        for (uint32_t i = 0; i < expression.size(); ++i) {
+            double* result = scratch.data() + i * blockRows;
+            expression.visit(i, [&](const auto& node) {
+                using N = std::decay_t<decltype(node)>;
+                if constexpr (std::is_same_v<N, flat::Constant>) {
+                    // Filled once up front
+                } else if constexpr (std::is_same_v<N, flat::Parameter>) {
+                    inputs[i] = columns[node.index].data() + begin;
+                } else if constexpr (std::is_same_v<N, flat::UnaryPlus>) {
+                    inputs[i] = inputs[node.input];
+                } else if constexpr (std::is_same_v<N, flat::UnaryMinus>) {
+                    const double* a = inputs[node.input];
+                    for (size_t r = 0; r < count; ++r) result[r] = applyOp(flat::typeOf<N>, a[r], 0.0);
+                } else {
+                    // The type is a constant here, so applyOp folds to one operation per loop
+                    const double* a = inputs[node.left];
+                    const double* b = inputs[node.right];
+                    for (size_t r = 0; r < count; ++r) result[r] = applyOp(flat::typeOf<N>, a[r], b[r]);
+                }
+            });
+        }
+
+        out.write(reinterpret_cast<const char*>(inputs[expression.root()]), static_cast<std::streamsize>(count * sizeof(double)));
+        if (!out) throw std::runtime_error("Cannot write " + outputPath);
+        for (auto& column : columns) column.release(begin + count);
+    }
+
+    out.close();
+    if (!out) throw std::runtime_error("Cannot write " + outputPath);
+    return numRows;
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
@@ -0,0 +1,63 @@
+#ifndef H_lib_ColumnEvaluator
+#define H_lib_ColumnEvaluator
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/FlatExpression.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// Read-only memory mapping of a column file: raw little-endian doubles
+class MappedColumn {
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is not a whole number of doubles
+    explicit MappedColumn(const std::string& path);
+    ~MappedColumn();
+
+    MappedColumn(const MappedColumn&) = delete;
+    MappedColumn& operator=(const MappedColumn&) = delete;
+    MappedColumn(MappedColumn&& other) noexcept;
+    MappedColumn& operator=(MappedColumn&& other) noexcept;
+
+    // Number of values
+    size_t size() const;
+    const double* data() const;
+    // Drop the pages holding the first rows values from memory. They are read
+    // from the file again if accessed later.
+    void release(size_t rows);
+
+private:
+    void* mapping = nullptr;
+    size_t length = 0;
+    size_t released = 0;
+};
+
+// Evaluates an expression over column files, one per parameter index, and
+// streams the results to an output column file. Rows are processed in blocks
+// straight from the mapped pages; consumed pages are released again, so
+// memory use depends on the expression size and the block size but not on
+// the number of rows.
+class ColumnEvaluator {
+public:
+    static constexpr size_t defaultBlockRows = 8192;
+
+    explicit ColumnEvaluator(const ASTNode& root, size_t blockRows = defaultBlockRows);
+
+    // columnPaths[i] holds parameter i; all columns must have the same number
+    // of rows. Returns the number of rows written. Throws std::out_of_range if
+    // the expression needs more columns, std::runtime_error on I/O errors.
+    size_t run(const std::vector<std::string>& columnPaths, const std::string& outputPath);
+
+private:
+    flat::Expression expression;
+    size_t parameterCount;
+    size_t blockRows;
+    // blockRows values per node
+    std::vector<double> scratch;
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
@@ -1,16 +1,49 @@
 #include "lib/EvaluationContext.hpp"
+#include "lib/AST.hpp"
 //---------------------------------------------------------------------------
 namespace ast {
 
+EvaluationContext::EvaluationContext(std::span<const double> values) : view(values) {}
+
+EvaluationContext::EvaluationContext(const EvaluationContext& other)
+    : parameters(other.parameters), view(other.view), validatedCount(other.validatedCount), validated(other.validated) {
+    // Do not alias the other context's own storage
+    if (other.view.data() == other.parameters.data()) view = parameters;
+}
+
+EvaluationContext& EvaluationContext::operator=(const EvaluationContext& other) {
+    if (this != &other) {
+        parameters = other.parameters;
+        view = other.view.data() == other.parameters.data() ? std::span<const double>(parameters) : other.view;
+        validatedCount = other.validatedCount;
+        validated = other.validated;
+    }
+    return *this;
+}
+
     void EvaluationContext::pushParameter(double value) {
+    if (view.data() != parameters.data()) {
+        // Switch from a bound buffer back to owned storage
+        parameters.assign(view.begin(), view.end());
+    }
     parameters.push_back(value);
+    view = parameters;
 }
 
-double EvaluationContext::getParameter(size_t index) const {
-        if (index >= parameters.size()) {
-            throw std::out_of_range("Index out of bounds in EvaluationContext");
-        }
-        return parameters[index];
+void EvaluationContext::bind(std::span<const double> values) {
+    if (values.size() < validatedCount) {
+        throw std::out_of_range("Bound values do not cover the validated expression");
     }
+    view = values;
+}
+
+void EvaluationContext::validate(const ASTNode& root) {
+    size_t count = requiredParameterCount(root);
+    if (count > view.size()) {
+        throw std::out_of_range("Index out of bounds in EvaluationContext");
+    }
+    validatedCount = count;
+    validated = true;
+}
 } // namespace ast
 //---------------------------------------------------------------------------
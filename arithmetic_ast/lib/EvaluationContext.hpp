@@ -1,17 +1,56 @@
 #ifndef H_lib_EvaluationContext
 #define H_lib_EvaluationContext
 //---------------------------------------------------------------------------
+#include <cstddef>
+#include <span>
 #include <vector>
 #include <stdexcept> // For std::out_of_range
 //---------------------------------------------------------------------------
 namespace ast {
+    class ASTNode;
+
+    // Parameter values for evaluation. The values either live in the context
+    // (pushParameter) or in a caller-owned buffer the context is bound to.
     class EvaluationContext {
 public:
+    EvaluationContext() = default;
+    // Bind to caller-owned values without copying them
+    explicit EvaluationContext(std::span<const double> values);
+    EvaluationContext(const EvaluationContext& other);
+    EvaluationContext& operator=(const EvaluationContext& other);
+    EvaluationContext(EvaluationContext&& other) noexcept = default;
+    EvaluationContext& operator=(EvaluationContext&& other) noexcept = default;
+
+    // Append a value to the context's own storage and read from there
     void pushParameter(double value);
-    double getParameter(size_t index) const;
+    // Rebind to the next caller-owned row in O(1)
+    void bind(std::span<const double> values);
+    // Check once that every Parameter in root is covered by the bound values.
+    // Afterwards lookups skip the per-node bounds check and bind() only checks
+    // the row length, so only trees validated against this context may be
+    // evaluated with it. Debug builds keep checking lookups against the
+    // validated tree and throw for parameters it does not have.
+    void validate(const ASTNode& root);
+
+    double getParameter(size_t index) const {
+#ifdef NDEBUG
+        bool checked = !validated;
+#else
+        bool checked = true;
+#endif
+        if (checked && index >= (validated ? validatedCount : view.size())) {
+            throw std::out_of_range("Index out of bounds in EvaluationContext");
+        }
+        return view[index];
+    }
+    size_t size() const { return view.size(); }
 
 private:
     std::vector<double> parameters;
+    std::span<const double> view;
+    // Parameter count of the validated tree
+    size_t validatedCount = 0;
+    bool validated = false;
 };
 
 } // namespace ast
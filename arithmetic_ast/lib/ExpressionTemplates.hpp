@@ -0,0 +1,298 @@
+#ifndef H_lib_ExpressionTemplates
+#define H_lib_ExpressionTemplates
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+//---------------------------------------------------------------------------
+// Compile-time mirror of the node set in AST.hpp. An expression is a type such
+// as Add<Parameter<0>, Multiply<Constant<2.0>, Parameter<1>>>; evaluating it
+// compiles to straight-line code without virtual dispatch. optimize() applies
+// the same rewrite rules as ASTNode::optimize at compile time and toAST()
+// builds the equivalent runtime tree, e.g. for printing with PrintVisitor.
+//---------------------------------------------------------------------------
+namespace ast::expr {
+
+// Common base of all expression types
+struct Node {};
+
+template <typename T>
+concept Expression = std::derived_from<T, Node>;
+
+namespace detail {
+
+// Whether value is a whole number that fits into a long long
+constexpr bool isIntegral(double value) {
+    return value > -0x1p63 && value < 0x1p63 && value == static_cast<double>(static_cast<long long>(value));
+}
+
+// std::pow is not constexpr; integral exponents are folded exactly at compile
+// time by square-and-multiply. Other exponents cannot be, so they make the
+// constant evaluation fail instead of giving a different result than at run
+// time.
+constexpr double power(double base, double exponent) {
+    if (std::is_constant_evaluated()) {
+        if (!isIntegral(exponent)) throw std::domain_error("Non-integral exponents cannot be evaluated at compile time");
+        auto n = static_cast<long long>(exponent);
+        auto remaining = static_cast<unsigned long long>(n < 0 ? -n : n);
+        double result = 1.0;
+        for (double factor = base; remaining; remaining >>= 1, factor *= factor)
+            if (remaining & 1) result *= factor;
+        return n < 0 ? 1.0 / result : result;
+    }
+    return std::pow(base, exponent);
+}
+
+} // namespace detail
+
+// --- Leaves --------------------------------------------------------------
+template <double V>
+struct Constant : Node {
+    static constexpr double value = V;
+    static constexpr size_t parameterCount = 0;
+    template <typename Params>
+    static constexpr double evaluate(const Params&) { return V; }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::Constant>(V); }
+};
+
+template <size_t I>
+struct Parameter : Node {
+    static constexpr size_t index = I;
+    static constexpr size_t parameterCount = I + 1;
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) { return params[I]; }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::Parameter>(I); }
+};
+
+// --- Unary nodes ---------------------------------------------------------
+template <Expression E>
+struct UnaryPlus : Node {
+    using Input = E;
+    static constexpr size_t parameterCount = E::parameterCount;
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) { return E::evaluate(params); }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::UnaryPlus>(E::toAST()); }
+};
+
+template <Expression E>
+struct UnaryMinus : Node {
+    using Input = E;
+    static constexpr size_t parameterCount = E::parameterCount;
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) { return -E::evaluate(params); }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::UnaryMinus>(E::toAST()); }
+};
+
+// --- Binary nodes --------------------------------------------------------
+template <Expression L, Expression R>
+struct Binary : Node {
+    using Left = L;
+    using Right = R;
+    static constexpr size_t parameterCount = L::parameterCount > R::parameterCount ? L::parameterCount : R::parameterCount;
+};
+
+template <Expression L, Expression R>
+struct Add : Binary<L, R> {
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) { return L::evaluate(params) + R::evaluate(params); }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::Add>(L::toAST(), R::toAST()); }
+};
+
+template <Expression L, Expression R>
+struct Subtract : Binary<L, R> {
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) { return L::evaluate(params) - R::evaluate(params); }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::Subtract>(L::toAST(), R::toAST()); }
+};
+
+template <Expression L, Expression R>
+struct Multiply : Binary<L, R> {
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) { return L::evaluate(params) * R::evaluate(params); }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::Multiply>(L::toAST(), R::toAST()); }
+};
+
+template <Expression L, Expression R>
+struct Divide : Binary<L, R> {
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) {
+        double rv = R::evaluate(params);
+        if (rv == 0.0) return 0.0; // same as Divide::evaluate
+        return L::evaluate(params) / rv;
+    }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::Divide>(L::toAST(), R::toAST()); }
+};
+
+template <Expression L, Expression R>
+struct Power : Binary<L, R> {
+    template <typename Params>
+    static constexpr double evaluate(const Params& params) { return detail::power(L::evaluate(params), R::evaluate(params)); }
+    static std::unique_ptr<ASTNode> toAST() { return std::make_unique<ast::Power>(L::toAST(), R::toAST()); }
+};
+
+// --- Builders ------------------------------------------------------------
+template <double V>
+inline constexpr Constant<V> constant{};
+template <size_t I>
+inline constexpr Parameter<I> parameter{};
+
+template <Expression E>
+constexpr UnaryPlus<E> operator+(E) { return {}; }
+template <Expression E>
+constexpr UnaryMinus<E> operator-(E) { return {}; }
+template <Expression L, Expression R>
+constexpr Add<L, R> operator+(L, R) { return {}; }
+template <Expression L, Expression R>
+constexpr Subtract<L, R> operator-(L, R) { return {}; }
+template <Expression L, Expression R>
+constexpr Multiply<L, R> operator*(L, R) { return {}; }
+template <Expression L, Expression R>
+constexpr Divide<L, R> operator/(L, R) { return {}; }
+// There is no operator^ because of its precedence
+template <Expression L, Expression R>
+constexpr Power<L, R> pow(L, R) { return {}; }
+
+// --- Optimization --------------------------------------------------------
+template <typename T>
+inline constexpr bool isConstant = false;
+template <double V>
+inline constexpr bool isConstant<Constant<V>> = true;
+
+template <typename T>
+inline constexpr bool isParameter = false;
+template <size_t I>
+inline constexpr bool isParameter<Parameter<I>> = true;
+
+template <typename T>
+inline constexpr bool isUnaryPlus = false;
+template <typename E>
+inline constexpr bool isUnaryPlus<UnaryPlus<E>> = true;
+
+template <typename T>
+inline constexpr bool isUnaryMinus = false;
+template <typename E>
+inline constexpr bool isUnaryMinus<UnaryMinus<E>> = true;
+
+template <typename T>
+inline constexpr bool isSubtract = false;
+template <typename L, typename R>
+inline constexpr bool isSubtract<Subtract<L, R>> = true;
+
+// Whether T is the constant v (false for all other node types)
+template <typename T>
+constexpr bool hasValue(double v) {
+    if constexpr (isConstant<T>) return T::value == v;
+    else return false;
+}
+
+// Whether T is a constant with an integral value
+template <typename T>
+constexpr bool isIntegralConstant() {
+    if constexpr (isConstant<T>) return detail::isIntegral(T::value);
+    else return false;
+}
+
+// Whether T is a Subtract whose left input is a UnaryMinus
+template <typename T>
+constexpr bool isSubtractOfNegated() {
+    if constexpr (isSubtract<T>) return isUnaryMinus<typename T::Left>;
+    else return false;
+}
+
+// The rules below mirror the optimize() implementations in AST.cpp one to one
+template <double V>
+constexpr auto optimize(Constant<V> e) { return e; }
+template <size_t I>
+constexpr auto optimize(Parameter<I> e) { return e; }
+
+template <typename E>
+constexpr auto optimize(UnaryPlus<E>) {
+    // Checked before the child is optimized, like UnaryPlus::optimize
+    if constexpr (isUnaryPlus<E> || isConstant<E> || isParameter<E>) return E{};
+    else return UnaryPlus<decltype(optimize(E{}))>{};
+}
+
+template <typename E>
+constexpr auto optimize(UnaryMinus<E>) {
+    using C = decltype(optimize(E{}));
+    if constexpr (isConstant<C>) return Constant<-C::value>{};
+    else if constexpr (isUnaryMinus<C>) return typename C::Input{};
+    else if constexpr (isSubtractOfNegated<C>()) return Add<typename C::Right, typename C::Left::Input>{};
+    else if constexpr (isSubtract<C>) return Subtract<typename C::Right, typename C::Left>{};
+    else return UnaryMinus<C>{};
+}
+
+template <typename L, typename R>
+constexpr auto optimize(Add<L, R>) {
+    using OL = decltype(optimize(L{}));
+    using OR = decltype(optimize(R{}));
+    if constexpr (isConstant<OL> && isConstant<OR>) return Constant<OL::value + OR::value>{};
+    else if constexpr (hasValue<OR>(0.0)) return OL{};
+    else if constexpr (hasValue<OL>(0.0)) return OR{};
+    else if constexpr (isUnaryMinus<OR>) return Subtract<OL, typename OR::Input>{};
+    else if constexpr (isUnaryMinus<OL>) return Subtract<OR, typename OL::Input>{};
+    else return Add<OL, OR>{};
+}
+
+template <typename L, typename R>
+constexpr auto optimize(Subtract<L, R>) {
+    using OL = decltype(optimize(L{}));
+    using OR = decltype(optimize(R{}));
+    if constexpr (isConstant<OL> && isConstant<OR>) return Constant<OL::value - OR::value>{};
+    else if constexpr (hasValue<OL>(0.0)) return UnaryMinus<OR>{};
+    else if constexpr (hasValue<OR>(0.0)) return OL{};
+    else if constexpr (isUnaryMinus<OR>) return Add<OL, typename OR::Input>{};
+    else return Subtract<OL, OR>{};
+}
+
+template <typename L, typename R>
+constexpr auto optimize(Multiply<L, R>) {
+    using OL = decltype(optimize(L{}));
+    using OR = decltype(optimize(R{}));
+    if constexpr (isConstant<OL> && isConstant<OR>) return Constant<OL::value * OR::value>{};
+    else if constexpr (hasValue<OL>(0.0)) return Constant<0.0>{};
+    else if constexpr (hasValue<OL>(1.0)) return OR{};
+    else if constexpr (hasValue<OR>(0.0)) return Constant<0.0>{};
+    else if constexpr (hasValue<OR>(1.0)) return OL{};
+    else if constexpr (isUnaryMinus<OL> && isUnaryMinus<OR>) return Multiply<typename OL::Input, typename OR::Input>{};
+    else return Multiply<OL, OR>{};
+}
+
+template <typename L, typename R>
+constexpr auto optimize(Divide<L, R>) {
+    using OL = decltype(optimize(L{}));
+    using OR = decltype(optimize(R{}));
+    if constexpr (hasValue<OL>(0.0)) return Constant<0.0>{};
+    else if constexpr (isConstant<OL> && isConstant<OR>) return Constant<(OR::value != 0.0 ? OL::value / OR::value : 0.0)>{};
+    else if constexpr (hasValue<OR>(1.0)) return OL{};
+    else if constexpr (isUnaryMinus<OL> && isUnaryMinus<OR>) return Divide<typename OL::Input, typename OR::Input>{};
+    // a / c -> a * (1 / c)
+    else if constexpr (isConstant<OR>) return Multiply<OL, Constant<(OR::value != 0.0 ? 1.0 / OR::value : 0.0)>>{};
+    else return Multiply<OL, Divide<Constant<1.0>, OR>>{};
+}
+
+template <typename L, typename R>
+constexpr auto optimize(Power<L, R>) {
+    using OL = decltype(optimize(L{}));
+    using OR = decltype(optimize(R{}));
+    // Only integral exponents can be folded exactly at compile time
+    if constexpr (isConstant<OL> && isIntegralConstant<OR>()) return Constant<detail::power(OL::value, OR::value)>{};
+    else if constexpr (hasValue<OR>(0.0)) return Constant<1.0>{};
+    else if constexpr (hasValue<OR>(1.0)) return OL{};
+    else if constexpr (hasValue<OR>(-1.0)) return Divide<Constant<1.0>, OL>{};
+    else if constexpr (hasValue<OL>(0.0)) return Constant<0.0>{};
+    else if constexpr (hasValue<OL>(1.0)) return Constant<1.0>{};
+    else return Power<OL, OR>{};
+}
+
+// The optimized form of an expression type
+template <Expression E>
+using Optimized = decltype(optimize(E{}));
+
+} // namespace ast::expr
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,149 @@
+#include "lib/FlatExpression.hpp"
+#include <stdexcept>
+#include <utility>
+//---------------------------------------------------------------------------
+namespace ast::flat {
+
+namespace {
+
+// Builds the tree node for one flat node from the already built inputs
+struct TreeBuilder {
+    std::vector<std::unique_ptr<ASTNode>>& built;
+
+    std::unique_ptr<ASTNode> operator()(const UnaryPlus& n) const { return std::make_unique<ast::UnaryPlus>(std::move(built[n.input])); }
+    std::unique_ptr<ASTNode> operator()(const UnaryMinus& n) const { return std::make_unique<ast::UnaryMinus>(std::move(built[n.input])); }
+    std::unique_ptr<ASTNode> operator()(const Add& n) const { return std::make_unique<ast::Add>(std::move(built[n.left]), std::move(built[n.right])); }
+    std::unique_ptr<ASTNode> operator()(const Subtract& n) const { return std::make_unique<ast::Subtract>(std::move(built[n.left]), std::move(built[n.right])); }
+    std::unique_ptr<ASTNode> operator()(const Multiply& n) const { return std::make_unique<ast::Multiply>(std::move(built[n.left]), std::move(built[n.right])); }
+    std::unique_ptr<ASTNode> operator()(const Divide& n) const { return std::make_unique<ast::Divide>(std::move(built[n.left]), std::move(built[n.right])); }
+    std::unique_ptr<ASTNode> operator()(const Power& n) const { return std::make_unique<ast::Power>(std::move(built[n.left]), std::move(built[n.right])); }
+    std::unique_ptr<ASTNode> operator()(const Constant& n) const { return std::make_unique<ast::Constant>(n.value); }
+    std::unique_ptr<ASTNode> operator()(const Parameter& n) const { return std::make_unique<ast::Parameter>(n.index); }
+};
+
+// Emits the text of one node and schedules its inputs, see printIteratively
+struct Printer {
+    struct Item {
+        uint32_t node;
+        const char* text;
+    };
+
+    std::ostream& out;
+    std::vector<Item>& items;
+
+    void unary(const char* prefix, uint32_t input) const {
+        out << prefix;
+        items.push_back({0, ")"});
+        items.push_back({input, nullptr});
+    }
+    void binary(const char* symbol, uint32_t left, uint32_t right) const {
+        out << "(";
+        items.push_back({0, ")"});
+        items.push_back({right, nullptr});
+        items.push_back({0, symbol});
+        items.push_back({left, nullptr});
+    }
+
+    void operator()(const UnaryPlus& n) const { unary("(+", n.input); }
+    void operator()(const UnaryMinus& n) const { unary("(-", n.input); }
+    void operator()(const Add& n) const { binary(" + ", n.left, n.right); }
+    void operator()(const Subtract& n) const { binary(" - ", n.left, n.right); }
+    void operator()(const Multiply& n) const { binary(" * ", n.left, n.right); }
+    void operator()(const Divide& n) const { binary(" / ", n.left, n.right); }
+    void operator()(const Power& n) const { binary(" ^ ", n.left, n.right); }
+    void operator()(const Constant& n) const { out << n.value; }
+    void operator()(const Parameter& n) const { out << "P" << n.index; }
+};
+
+} // namespace
+
+Expression::Expression(const ASTNode& root) {
+    // Post-order walk with an explicit stack; inputs leave their index on
+    // results for the node using them
+    struct Frame {
+        const ASTNode* node;
+        bool expanded;
+    };
+    std::vector<Frame> frames{{&root, false}};
+    std::vector<uint32_t> results;
+    auto pop = [&results] {
+        uint32_t index = results.back();
+        results.pop_back();
+        return index;
+    };
+
+    while (!frames.empty()) {
+        auto [node, expanded] = frames.back();
+        frames.pop_back();
+        auto type = node->getType();
+
+        if (!expanded && type != ASTNode::Type::Constant && type != ASTNode::Type::Parameter) {
+            frames.push_back({node, true});
+            if (type == ASTNode::Type::UnaryPlus) {
+                frames.push_back({&static_cast<const ast::UnaryPlus*>(node)->getInput(), false});
+            } else if (type == ASTNode::Type::UnaryMinus) {
+                frames.push_back({&static_cast<const ast::UnaryMinus*>(node)->getInput(), false});
+            } else {
+                auto bin = static_cast<const BinaryASTNode*>(node);
+                frames.push_back({&bin->getRight(), false});
+                frames.push_back({&bin->getLeft(), false});
+            }
+            continue;
+        }
+
+        if (nodes.size() >= UINT32_MAX) throw std::length_error("Expression too large for 32-bit node indices");
+        switch (type) {
+            case ASTNode::Type::Constant: nodes.emplace_back(Constant{static_cast<const ast::Constant*>(node)->getValue()}); break;
+            case ASTNode::Type::Parameter: nodes.emplace_back(Parameter{static_cast<const ast::Parameter*>(node)->getIndex()}); break;
+            case ASTNode::Type::UnaryPlus: nodes.emplace_back(UnaryPlus{pop()}); break;
+            case ASTNode::Type::UnaryMinus: nodes.emplace_back(UnaryMinus{pop()}); break;
+            default: {
+                uint32_t right = pop();
+                uint32_t left = pop();
+                switch (type) {
+                    case ASTNode::Type::Add: nodes.emplace_back(Add{left, right}); break;
+                    case ASTNode::Type::Subtract: nodes.emplace_back(Subtract{left, right}); break;
+                    case ASTNode::Type::Multiply: nodes.emplace_back(Multiply{left, right}); break;
+                    case ASTNode::Type::Divide: nodes.emplace_back(Divide{left, right}); break;
+                    default: nodes.emplace_back(Power{left, right}); break;
+                }
+                break;
+            }
+        }
+        results.push_back(static_cast<uint32_t>(nodes.size() - 1));
+    }
+}
+
+std::unique_ptr<ASTNode> Expression::toTree() const {
+    // Inputs come first, so one forward sweep builds every subtree before it is used
+    std::vector<std::unique_ptr<ASTNode>> built(nodes.size());
+    TreeBuilder builder{built};
+    for (size_t i = 0; i < nodes.size(); ++i) built[i] = std::visit(builder, nodes[i]);
+    return std::move(built.back());
+}
+
+double Expression::evaluate(const EvaluationContext& ctx, std::vector<double>& scratch) const {
+    scratch.resize(nodes.size());
+    auto parameter = [&ctx](size_t index) { return ctx.getParameter(index); };
+    for (uint32_t i = 0; i < nodes.size(); ++i) scratch[i] = computeNode(i, scratch.data(), parameter);
+    return scratch.back();
+}
+
+double Expression::evaluate(const EvaluationContext& ctx) const {
+    std::vector<double> scratch;
+    return evaluate(ctx, scratch);
+}
+
+void Expression::print(std::ostream& out) const {
+    std::vector<Printer::Item> items{{root(), nullptr}};
+    Printer printer{out, items};
+    while (!items.empty()) {
+        Printer::Item item = items.back();
+        items.pop_back();
+        if (item.text) out << item.text;
+        else std::visit(printer, nodes[item.node]);
+    }
+}
+
+} // namespace ast::flat
+//---------------------------------------------------------------------------
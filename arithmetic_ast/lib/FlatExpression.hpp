@@ -0,0 +1,129 @@
+#ifndef H_lib_FlatExpression
+#define H_lib_FlatExpression
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+//---------------------------------------------------------------------------
+// Devirtualised representation of an expression. All nodes live in one
+// contiguous vector in post-order (inputs before the node using them, root
+// last) and refer to their inputs by 32-bit index. A node is a std::variant
+// whose alternatives mirror the ASTNode subclasses, in the order of
+// ASTNode::Type, so visitors dispatch with std::visit instead of virtual
+// calls and double dispatch.
+//---------------------------------------------------------------------------
+namespace ast::flat {
+
+struct UnaryPlus {
+    uint32_t input;
+};
+struct UnaryMinus {
+    uint32_t input;
+};
+struct Add {
+    uint32_t left;
+    uint32_t right;
+};
+struct Subtract {
+    uint32_t left;
+    uint32_t right;
+};
+struct Multiply {
+    uint32_t left;
+    uint32_t right;
+};
+struct Divide {
+    uint32_t left;
+    uint32_t right;
+};
+struct Power {
+    uint32_t left;
+    uint32_t right;
+};
+struct Constant {
+    double value;
+};
+struct Parameter {
+    size_t index;
+};
+
+using Node = std::variant<UnaryPlus, UnaryMinus, Add, Subtract, Multiply, Divide, Power, Constant, Parameter>;
+
+namespace detail {
+template <typename N, size_t I = 0>
+constexpr size_t alternativeIndex() {
+    if constexpr (std::is_same_v<N, std::variant_alternative_t<I, Node>>) return I;
+    else return alternativeIndex<N, I + 1>();
+}
+} // namespace detail
+
+// ASTNode::Type of a node alternative
+template <typename N>
+constexpr ASTNode::Type typeOf = static_cast<ASTNode::Type>(detail::alternativeIndex<N>());
+
+// Input indices of a node; right is 0 for unary nodes, both are 0 for leaves
+struct Inputs {
+    uint32_t left = 0;
+    uint32_t right = 0;
+};
+
+class Expression {
+public:
+    // Lossless conversion from a tree; throws std::length_error beyond 2^32 nodes
+    explicit Expression(const ASTNode& root);
+    // Build the equivalent tree
+    std::unique_ptr<ASTNode> toTree() const;
+
+    size_t size() const { return nodes.size(); }
+    uint32_t root() const { return static_cast<uint32_t>(nodes.size() - 1); }
+    const Node& operator[](uint32_t index) const { return nodes[index]; }
+    ASTNode::Type getType(uint32_t index) const { return static_cast<ASTNode::Type>(nodes[index].index()); }
+
+    // Dispatch visitor on the node at index
+    template <typename Visitor>
+    decltype(auto) visit(uint32_t index, Visitor&& visitor) const {
+        return std::visit(std::forward<Visitor>(visitor), nodes[index]);
+    }
+
+    Inputs getInputs(uint32_t index) const {
+        return visit(index, [](const auto& n) {
+            if constexpr (requires { n.left; }) return Inputs{n.left, n.right};
+            else if constexpr (requires { n.input; }) return Inputs{n.input, 0};
+            else return Inputs{};
+        });
+    }
+
+    // Value of the node at index, given the values of all nodes before it.
+    // parameter(i) supplies the value of parameter i.
+    template <typename ParameterSource>
+    double computeNode(uint32_t index, const double* values, const ParameterSource& parameter) const {
+        return visit(index, [&](const auto& n) {
+            using N = std::decay_t<decltype(n)>;
+            if constexpr (std::is_same_v<N, Constant>) return n.value;
+            else if constexpr (std::is_same_v<N, Parameter>) return static_cast<double>(parameter(n.index));
+            else if constexpr (requires { n.input; }) return applyOp(typeOf<N>, values[n.input], 0.0);
+            else return applyOp(typeOf<N>, values[n.left], values[n.right]);
+        });
+    }
+
+    // Same result as ASTNode::evaluate, computed in one sweep over the nodes.
+    // scratch receives the value of every node and can be reused across calls.
+    double evaluate(const EvaluationContext& ctx, std::vector<double>& scratch) const;
+    double evaluate(const EvaluationContext& ctx) const;
+    // Same output as accept(PrintVisitor) on the tree
+    void print(std::ostream& out = std::cout) const;
+
+private:
+    std::vector<Node> nodes;
+};
+
+} // namespace ast::flat
+//---------------------------------------------------------------------------
+#endif
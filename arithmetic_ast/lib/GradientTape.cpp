@@ -0,0 +1,101 @@
+#include "lib/GradientTape.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <variant>
+//---------------------------------------------------------------------------
+namespace ast {
+
+GradientTape::GradientTape(const ASTNode& root, const EvaluationContext& ctx)
+    : tape(root), values(tape.size()), parameterCount(requiredParameterCount(root)) {
+    forward([&ctx](size_t index) { return ctx.getParameter(index); });
+}
+
+template <typename ParameterSource>
+void GradientTape::forward(const ParameterSource& parameter) {
+    for (uint32_t i = 0; i < tape.size(); ++i) values[i] = tape.computeNode(i, values.data(), parameter);
+}
+
+void GradientTape::reverse(double* gradOut) {
+    std::fill(gradOut, gradOut + parameterCount, 0.0);
+    adjoints.assign(tape.size(), 0.0);
+    adjoints.back() = 1.0;
+
+    for (uint32_t i = tape.root() + 1; i-- > 0;) {
+        double g = adjoints[i];
+        if (g == 0.0) continue;
+        flat::Inputs e = tape.getInputs(i);
+        switch (tape.getType(i)) {
+            case ASTNode::Type::Constant: break;
+            case ASTNode::Type::Parameter: gradOut[std::get<flat::Parameter>(tape[i]).index] += g; break;
+            case ASTNode::Type::UnaryPlus: adjoints[e.left] += g; break;
+            case ASTNode::Type::UnaryMinus: adjoints[e.left] -= g; break;
+            case ASTNode::Type::Add:
+                adjoints[e.left] += g;
+                adjoints[e.right] += g;
+                break;
+            case ASTNode::Type::Subtract:
+                adjoints[e.left] += g;
+                adjoints[e.right] -= g;
+                break;
+            case ASTNode::Type::Multiply:
+                adjoints[e.left] += g * values[e.right];
+                adjoints[e.right] += g * values[e.left];
+                break;
+            case ASTNode::Type::Divide: {
+                // A zero divisor yields the constant 0, so it has no gradient
+                double b = values[e.right];
+                if (b == 0.0) break;
+                adjoints[e.left] += g / b;
+                adjoints[e.right] -= g * values[i] / b;
+                break;
+            }
+            case ASTNode::Type::Power: {
+                double a = values[e.left];
+                double b = values[e.right];
+                if (b != 0.0) adjoints[e.left] += g * b * std::pow(a, b - 1.0);
+                // d/db a^b = a^b * ln(a) is only real for positive bases
+                if (a > 0.0) adjoints[e.right] += g * values[i] * std::log(a);
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+size_t GradientTape::getParameterCount() const { return parameterCount; }
+double GradientTape::getValue() const { return values.back(); }
+
+void GradientTape::gradient(std::vector<double>& gradOut) {
+    gradOut.resize(parameterCount);
+    reverse(gradOut.data());
+}
+
+double GradientTape::evaluateWithGradient(const EvaluationContext& ctx, std::vector<double>& gradOut) {
+    forward([&ctx](size_t index) { return ctx.getParameter(index); });
+    gradient(gradOut);
+    return getValue();
+}
+
+void GradientTape::evaluateWithGradient(std::span<const double> rows, size_t rowWidth, std::span<double> results, std::span<double> gradients) {
+    if (rowWidth < parameterCount) throw std::out_of_range("Row width too small for the recorded expression");
+    size_t numRows = results.size();
+    if (rows.size() < numRows * rowWidth || gradients.size() < numRows * parameterCount)
+        throw std::out_of_range("Batch buffers too small in GradientTape");
+
+    for (size_t r = 0; r < numRows; ++r) {
+        const double* row = rows.data() + r * rowWidth;
+        forward([row](size_t index) { return row[index]; });
+        reverse(gradients.data() + r * parameterCount);
+        results[r] = getValue();
+    }
+}
+
+double evaluateWithGradient(const ASTNode& root, const EvaluationContext& ctx, std::vector<double>& gradOut) {
+    GradientTape tape(root, ctx);
+    tape.gradient(gradOut);
+    return tape.getValue();
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
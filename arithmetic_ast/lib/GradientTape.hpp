@@ -0,0 +1,52 @@
+#ifndef H_lib_GradientTape
+#define H_lib_GradientTape
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/FlatExpression.hpp"
+#include <cstddef>
+#include <span>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// Reverse-mode automatic differentiation. The tape is the flat::Expression of
+// the tree, recorded without recursion: a forward sweep stores the value of
+// every operation, and a single reverse sweep over the tape then yields the
+// partial derivatives for all parameters at once.
+class GradientTape {
+public:
+    // Record the tape for root with the parameters in ctx
+    GradientTape(const ASTNode& root, const EvaluationContext& ctx);
+
+    // Number of partial derivatives produced (largest Parameter index + 1)
+    size_t getParameterCount() const;
+    // Value of the expression for the most recent forward pass
+    double getValue() const;
+    // Reverse sweep over the most recent forward pass; resizes gradOut
+    void gradient(std::vector<double>& gradOut);
+
+    // Replay the recorded tape for new parameters, then sweep backwards
+    double evaluateWithGradient(const EvaluationContext& ctx, std::vector<double>& gradOut);
+    // Batched form reusing the tape across rows. rows holds rowWidth parameter
+    // values per row; results receives one value and gradients
+    // getParameterCount() partials per row.
+    void evaluateWithGradient(std::span<const double> rows, size_t rowWidth, std::span<double> results, std::span<double> gradients);
+
+private:
+    flat::Expression tape;
+    std::vector<double> values;
+    std::vector<double> adjoints;
+    size_t parameterCount = 0;
+
+    template <typename ParameterSource>
+    void forward(const ParameterSource& parameter);
+    void reverse(double* gradOut);
+};
+
+// Evaluate root and compute all partial derivatives with one reverse sweep
+double evaluateWithGradient(const ASTNode& root, const EvaluationContext& ctx, std::vector<double>& gradOut);
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
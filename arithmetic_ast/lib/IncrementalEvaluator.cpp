@@ -0,0 +1,90 @@
+#include "lib/IncrementalEvaluator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <variant>
+#include <stdexcept>
+//---------------------------------------------------------------------------
+namespace ast {
+
+IncrementalEvaluator::IncrementalEvaluator(const ASTNode& root, const EvaluationContext& ctx) : expression(root) {
+    size_t parameterCount = requiredParameterCount(root);
+    if (parameterCount > ctx.size()) throw std::out_of_range("Index out of bounds in EvaluationContext");
+    for (size_t i = 0; i < parameterCount; ++i) parameters.push_back(ctx.getParameter(i));
+    leaves.resize(parameterCount);
+
+    // flat::Expression has fewer than 2^32 nodes, so noParent is no node index
+    parents.assign(expression.size(), noParent);
+    for (uint32_t i = 0; i < expression.size(); ++i) {
+        switch (expression.getType(i)) {
+            case ASTNode::Type::Constant: break;
+            case ASTNode::Type::Parameter: leaves[std::get<flat::Parameter>(expression[i]).index].push_back(i); break;
+            case ASTNode::Type::UnaryPlus:
+            case ASTNode::Type::UnaryMinus: parents[expression.getInputs(i).left] = i; break;
+            default: {
+                auto [left, right] = expression.getInputs(i);
+                parents[left] = i;
+                parents[right] = i;
+                break;
+            }
+        }
+    }
+    values.resize(expression.size());
+    for (uint32_t i = 0; i < expression.size(); ++i) values[i] = compute(i);
+    queued.assign(expression.size(), false);
+}
+
+double IncrementalEvaluator::compute(uint32_t node) const {
+    return expression.computeNode(node, values.data(), [this](size_t index) { return parameters[index]; });
+}
+
+double IncrementalEvaluator::getValue() const { return values.back(); }
+
+double IncrementalEvaluator::getParameter(size_t index) const {
+    if (index >= parameters.size()) throw std::out_of_range("Index out of bounds in IncrementalEvaluator");
+    return parameters[index];
+}
+
+size_t IncrementalEvaluator::getParameterCount() const { return parameters.size(); }
+
+size_t IncrementalEvaluator::getNodeCount() const { return expression.size(); }
+
+void IncrementalEvaluator::setParameter(size_t index, double value) {
+    if (index >= parameters.size()) throw std::out_of_range("Index out of bounds in IncrementalEvaluator");
+    parameters[index] = value;
+    lastRecomputed = 0;
+
+    // Min-heap of dirty nodes. Parents always have larger indices than their
+    // inputs, so a node is recomputed only after all of its dirty inputs.
+    auto enqueue = [&](uint32_t node) {
+        if (queued[node]) return;
+        queued[node] = true;
+        pending.push_back(node);
+        std::push_heap(pending.begin(), pending.end(), std::greater<>());
+    };
+    for (uint32_t leaf : leaves[index]) enqueue(leaf);
+
+    while (!pending.empty()) {
+        std::pop_heap(pending.begin(), pending.end(), std::greater<>());
+        uint32_t node = pending.back();
+        pending.pop_back();
+        queued[node] = false;
+
+        double updated = compute(node);
+        ++lastRecomputed;
+        // Unchanged values cut the propagation short. NaN never compares
+        // equal, which only means propagating conservatively.
+        if (updated == values[node] && std::signbit(updated) == std::signbit(values[node])) continue;
+        values[node] = updated;
+        if (parents[node] != noParent) enqueue(parents[node]);
+    }
+}
+
+size_t IncrementalEvaluator::getLastRecomputed() const { return lastRecomputed; }
+
+double IncrementalEvaluator::getRecomputationRatio() const {
+    return static_cast<double>(lastRecomputed) / static_cast<double>(expression.size());
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
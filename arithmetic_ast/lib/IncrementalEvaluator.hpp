@@ -0,0 +1,59 @@
+#ifndef H_lib_IncrementalEvaluator
+#define H_lib_IncrementalEvaluator
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/FlatExpression.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// Keeps the value of every node of an expression and recomputes only what a
+// parameter change affects. The tree is flattened into a flat::Expression,
+// so every node comes after its inputs. Each Parameter leaf is indexed by parameter,
+// and parent links give the path from a leaf to the root; together they
+// record which parameters every subtree depends on. An update recomputes
+// the nodes on those paths bottom-up and stops early where a value does not
+// change.
+class IncrementalEvaluator {
+public:
+    // Flatten root and evaluate it once with the parameters in ctx
+    IncrementalEvaluator(const ASTNode& root, const EvaluationContext& ctx);
+
+    // Value of the expression for the current parameters
+    double getValue() const;
+    double getParameter(size_t index) const;
+    size_t getParameterCount() const;
+    size_t getNodeCount() const;
+
+    // Change one parameter and bring all cached values up to date
+    void setParameter(size_t index, double value);
+
+    // Nodes recomputed by the most recent setParameter
+    size_t getLastRecomputed() const;
+    // getLastRecomputed() / getNodeCount(); 1.0 means a full re-evaluation
+    double getRecomputationRatio() const;
+
+private:
+    static constexpr uint32_t noParent = UINT32_MAX;
+
+    flat::Expression expression;
+    // Node using each node as input, noParent for the root
+    std::vector<uint32_t> parents;
+    std::vector<double> values;
+    std::vector<double> parameters;
+    // Parameter leaves per parameter index
+    std::vector<std::vector<uint32_t>> leaves;
+    // Scratch state of setParameter
+    std::vector<uint32_t> pending;
+    std::vector<bool> queued;
+    size_t lastRecomputed = 0;
+
+    double compute(uint32_t node) const;
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
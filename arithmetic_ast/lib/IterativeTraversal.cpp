@@ -0,0 +1,180 @@
+#include "lib/IterativeTraversal.hpp"
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+namespace {
+
+const char* operatorSymbol(ASTNode::Type type) {
+    switch (type) {
+        case ASTNode::Type::Add: return " + ";
+        case ASTNode::Type::Subtract: return " - ";
+        case ASTNode::Type::Multiply: return " * ";
+        case ASTNode::Type::Divide: return " / ";
+        default: return " ^ ";
+    }
+}
+
+} // namespace
+
+// --- Evaluate ------------------------------------------------------------
+double evaluateIteratively(const ASTNode& root, const EvaluationContext& ctx) {
+    // Descend along left inputs, pushing one frame per UnaryMinus and binary
+    // node; leaves are evaluated in place and never touch the stack. Going
+    // back up, a binary node stores its first value and descends to the other
+    // input. Like Divide::evaluate, a division computes its right input first
+    // and skips the left one when the divisor is zero.
+    struct Frame {
+        const ASTNode* node;
+        ASTNode::Type type;
+        bool firstDone;
+        double first;
+    };
+    std::vector<Frame> frames;
+    const ASTNode* node = &root;
+    double value = 0.0;
+
+    while (true) {
+        while (true) {
+            auto type = node->getType();
+            if (type == ASTNode::Type::Constant) {
+                value = static_cast<const Constant*>(node)->getValue();
+                break;
+            }
+            if (type == ASTNode::Type::Parameter) {
+                value = ctx.getParameter(static_cast<const Parameter*>(node)->getIndex());
+                break;
+            }
+            if (type == ASTNode::Type::UnaryPlus) {
+                node = &static_cast<const UnaryPlus*>(node)->getInput();
+                continue;
+            }
+            frames.push_back({node, type, false, 0.0});
+            if (type == ASTNode::Type::UnaryMinus) node = &static_cast<const UnaryMinus*>(node)->getInput();
+            else if (type == ASTNode::Type::Divide) node = &static_cast<const BinaryASTNode*>(node)->getRight();
+            else node = &static_cast<const BinaryASTNode*>(node)->getLeft();
+        }
+
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            if (frame.type == ASTNode::Type::UnaryMinus) {
+                value = applyOp(frame.type, value, 0.0);
+            } else if (frame.type == ASTNode::Type::Divide && !frame.firstDone && value == 0.0) {
+                value = 0.0;
+            } else if (!frame.firstDone) {
+                frame.first = value;
+                frame.firstDone = true;
+                auto& binary = *static_cast<const BinaryASTNode*>(frame.node);
+                node = frame.type == ASTNode::Type::Divide ? &binary.getLeft() : &binary.getRight();
+                break;
+            } else {
+                if (frame.type == ASTNode::Type::Divide) value = applyOp(frame.type, value, frame.first);
+                else value = applyOp(frame.type, frame.first, value);
+            }
+            frames.pop_back();
+        }
+        if (frames.empty()) return value;
+    }
+}
+
+// --- Optimize ------------------------------------------------------------
+void optimizeIteratively(std::unique_ptr<ASTNode>& root) {
+    // Frames point at the owning slot of a node, so that simplify() can
+    // replace the node in its parent. A slot stays valid until its parent is
+    // expanded, which happens only after all of its inputs are done.
+    struct Frame {
+        std::unique_ptr<ASTNode>* slot;
+        bool expanded;
+    };
+    std::vector<Frame> frames{{&root, false}};
+
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        ASTNode* node = frame.slot->get();
+        if (!node) {
+            frames.pop_back();
+            continue;
+        }
+        if (frame.expanded) {
+            auto* slot = frame.slot;
+            frames.pop_back();
+            node->simplify(*slot);
+            continue;
+        }
+        frame.expanded = true;
+
+        switch (node->getType()) {
+            case ASTNode::Type::Constant:
+            case ASTNode::Type::Parameter:
+                frames.pop_back();
+                break;
+            case ASTNode::Type::UnaryPlus: {
+                // Checked before the input is optimized, like UnaryPlus::optimize
+                auto unary = static_cast<UnaryPlus*>(node);
+                auto* slot = frame.slot;
+                frames.pop_back();
+                if (unary->getMutableInput() && !unary->collapse(*slot)) frames.push_back({&unary->getMutableInput(), false});
+                break;
+            }
+            case ASTNode::Type::UnaryMinus:
+                frames.push_back({&static_cast<UnaryMinus*>(node)->getMutableInput(), false});
+                break;
+            default: {
+                auto bin = static_cast<BinaryASTNode*>(node);
+                frames.push_back({&bin->getMutableRight(), false});
+                frames.push_back({&bin->getMutableLeft(), false});
+                break;
+            }
+        }
+    }
+}
+
+// --- Print ---------------------------------------------------------------
+void printIteratively(const ASTNode& root, std::ostream& out) {
+    // Each item is either a node still to be printed or a piece of text
+    struct Item {
+        const ASTNode* node;
+        const char* text;
+    };
+    std::vector<Item> items{{&root, nullptr}};
+
+    while (!items.empty()) {
+        Item item = items.back();
+        items.pop_back();
+        if (!item.node) {
+            out << item.text;
+            continue;
+        }
+        const ASTNode* node = item.node;
+        switch (node->getType()) {
+            case ASTNode::Type::Constant:
+                out << static_cast<const Constant*>(node)->getValue();
+                break;
+            case ASTNode::Type::Parameter:
+                out << "P" << static_cast<const Parameter*>(node)->getIndex();
+                break;
+            case ASTNode::Type::UnaryPlus:
+                out << "(+";
+                items.push_back({nullptr, ")"});
+                items.push_back({&static_cast<const UnaryPlus*>(node)->getInput(), nullptr});
+                break;
+            case ASTNode::Type::UnaryMinus:
+                out << "(-";
+                items.push_back({nullptr, ")"});
+                items.push_back({&static_cast<const UnaryMinus*>(node)->getInput(), nullptr});
+                break;
+            default: {
+                auto bin = static_cast<const BinaryASTNode*>(node);
+                out << "(";
+                items.push_back({nullptr, ")"});
+                items.push_back({&bin->getRight(), nullptr});
+                items.push_back({nullptr, operatorSymbol(node->getType())});
+                items.push_back({&bin->getLeft(), nullptr});
+                break;
+            }
+        }
+    }
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
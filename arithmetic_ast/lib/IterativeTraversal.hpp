@@ -0,0 +1,25 @@
+#ifndef H_lib_IterativeTraversal
+#define H_lib_IterativeTraversal
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include <iostream>
+#include <memory>
+//---------------------------------------------------------------------------
+// Non-recursive counterparts of ASTNode::evaluate, ASTNode::optimize and
+// PrintVisitor. They walk the tree with an explicit stack on the heap, so
+// degenerate trees (e.g. a left-deep chain of 10^6 Add nodes) neither
+// overflow the call stack nor pay a virtual call per node. Results are
+// identical to the recursive versions. Node destructors are non-recursive
+// as well, see AST.cpp.
+//---------------------------------------------------------------------------
+namespace ast {
+
+double evaluateIteratively(const ASTNode& root, const EvaluationContext& ctx);
+void optimizeIteratively(std::unique_ptr<ASTNode>& root);
+// Same output as root.accept(PrintVisitor)
+void printIteratively(const ASTNode& root, std::ostream& out = std::cout);
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,292 @@
+#include "lib/JITCompiler.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/IterativeTraversal.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// --- CodeBuffer ----------------------------------------------------------
+CodeBuffer::CodeBuffer(const std::vector<uint8_t>& code) {
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t bytes = ((code.size() + pageSize - 1) / pageSize) * pageSize;
+    if (bytes == 0) bytes = pageSize;
+
+    void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) throw std::runtime_error("Cannot map memory for generated code");
+    std::memcpy(mem, code.data(), code.size());
+    if (mprotect(mem, bytes, PROT_READ | PROT_EXEC) != 0) {
+        munmap(mem, bytes);
+        throw std::runtime_error("Cannot make generated code executable");
+    }
+    memory = mem;
+    length = bytes;
+}
+
+CodeBuffer::~CodeBuffer() {
+    if (memory) munmap(memory, length);
+}
+
+CodeBuffer::CodeBuffer(CodeBuffer&& other) noexcept : memory(other.memory), length(other.length) {
+    other.memory = nullptr;
+    other.length = 0;
+}
+
+CodeBuffer& CodeBuffer::operator=(CodeBuffer&& other) noexcept {
+    if (this != &other) {
+        if (memory) munmap(memory, length);
+        memory = other.memory;
+        length = other.length;
+        other.memory = nullptr;
+        other.length = 0;
+    }
+    return *this;
+}
+
+const void* CodeBuffer::data() const { return memory; }
+size_t CodeBuffer::size() const { return length; }
+
+// --- Code generation -----------------------------------------------------
+namespace {
+
+double callPow(double base, double exponent) { return std::pow(base, exponent); }
+
+// Integer exponents up to this magnitude are expanded into square-and-multiply
+constexpr double maxInlinePower = 1024.0;
+// Spilled operands the generated code may keep on the machine stack at once
+// (256 KiB); deeper expressions are interpreted
+constexpr size_t maxSpillDepth = 1 << 15;
+
+// Emits SSE2 scalar code. Every node leaves its value in xmm0; the left
+// operand of a binary node is spilled to the machine stack while the right
+// one is computed. rbx holds the parameter pointer across calls to pow.
+// The tree is walked with an explicit stack of tasks, so deep trees do not
+// overflow the stack of the compiler itself.
+class Emitter {
+public:
+    std::vector<uint8_t> code;
+
+    void prologue() {
+        emit({0x53});             // push rbx
+        emit({0x48, 0x89, 0xFB}); // mov rbx, rdi
+    }
+
+    void epilogue() {
+        emit({0x5B}); // pop rbx
+        emit({0xC3}); // ret
+    }
+
+    void generate(const ASTNode& root) {
+        std::vector<Task> tasks{{Action::Generate, &root}};
+        while (!tasks.empty()) {
+            Task task = tasks.back();
+            tasks.pop_back();
+            const ASTNode& node = *task.node;
+            switch (task.action) {
+                case Action::Generate: expand(node, tasks); break;
+                case Action::Negate:
+                    loadConstant(1, -0.0);
+                    emit({0x66, 0x0F, 0x57, 0xC1}); // xorpd xmm0, xmm1
+                    break;
+                case Action::Power:
+                    integerPower(static_cast<int64_t>(static_cast<const Constant&>(static_cast<const BinaryASTNode&>(node).getRight()).getValue()));
+                    break;
+                case Action::Spill:
+                    emit({0x48, 0x83, 0xEC, 0x08});       // sub rsp, 8
+                    emit({0xF2, 0x0F, 0x11, 0x04, 0x24}); // movsd [rsp], xmm0
+                    maxDepth = std::max(maxDepth, ++depth);
+                    tasks.push_back({Action::Generate, &static_cast<const BinaryASTNode&>(node).getRight()});
+                    break;
+                case Action::Combine: combine(static_cast<const BinaryASTNode&>(node), node.getType()); break;
+            }
+        }
+    }
+
+    // Largest number of operands spilled at once by the generated code
+    size_t getMaxDepth() const { return maxDepth; }
+
+private:
+    // What is left to do for a node. Generate schedules the others: the
+    // inputs first, then the code that combines their values.
+    enum class Action { Generate, Negate, Power, Spill, Combine };
+    struct Task {
+        Action action;
+        const ASTNode* node;
+    };
+
+    // Number of 8 byte slots currently spilled below the saved rbx
+    size_t depth = 0;
+    size_t maxDepth = 0;
+
+    void emit(std::initializer_list<uint8_t> bytes) {
+        for (uint8_t byte : bytes) code.push_back(byte);
+    }
+
+    void emitImmediate(uint64_t value, unsigned bytes) {
+        for (unsigned i = 0; i < bytes; ++i) code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    static bool isLeaf(const ASTNode& node) {
+        return node.getType() == ASTNode::Type::Constant || node.getType() == ASTNode::Type::Parameter;
+    }
+
+    // Load a constant into xmm0 or xmm1 (clobbers rax)
+    void loadConstant(unsigned reg, double value) {
+        emit({0x48, 0xB8}); // mov rax, imm64
+        emitImmediate(std::bit_cast<uint64_t>(value), 8);
+        emit({0x66, 0x48, 0x0F, 0x6E, static_cast<uint8_t>(0xC0 | (reg << 3))}); // movq xmmN, rax
+    }
+
+    void loadLeaf(unsigned reg, const ASTNode& node) {
+        if (node.getType() == ASTNode::Type::Constant) {
+            loadConstant(reg, static_cast<const Constant&>(node).getValue());
+            return;
+        }
+        size_t offset = static_cast<const Parameter&>(node).getIndex() * sizeof(double);
+        emit({0xF2, 0x0F, 0x10, static_cast<uint8_t>(0x83 | (reg << 3))}); // movsd xmmN, [rbx + disp32]
+        emitImmediate(offset, 4);
+    }
+
+    void expand(const ASTNode& node, std::vector<Task>& tasks) {
+        switch (node.getType()) {
+            case ASTNode::Type::Constant:
+            case ASTNode::Type::Parameter:
+                loadLeaf(0, node);
+                return;
+            case ASTNode::Type::UnaryPlus:
+                tasks.push_back({Action::Generate, &static_cast<const UnaryPlus&>(node).getInput()});
+                return;
+            case ASTNode::Type::UnaryMinus:
+                tasks.push_back({Action::Negate, &node});
+                tasks.push_back({Action::Generate, &static_cast<const UnaryMinus&>(node).getInput()});
+                return;
+            default: break;
+        }
+
+        auto& bin = static_cast<const BinaryASTNode&>(node);
+        if (node.getType() == ASTNode::Type::Power && bin.getRight().getType() == ASTNode::Type::Constant) {
+            double exponent = static_cast<const Constant&>(bin.getRight()).getValue();
+            if (exponent == std::trunc(exponent) && std::fabs(exponent) <= maxInlinePower) {
+                tasks.push_back({Action::Power, &node});
+                tasks.push_back({Action::Generate, &bin.getLeft()});
+                return;
+            }
+        }
+        // Left operand ends up in xmm0, right operand in xmm1
+        tasks.push_back({Action::Combine, &node});
+        if (!isLeaf(bin.getRight())) tasks.push_back({Action::Spill, &node});
+        tasks.push_back({Action::Generate, &bin.getLeft()});
+    }
+
+    // Both operands are computed: a leaf right operand is still to be
+    // loaded with the left one in xmm0, otherwise the right one is in xmm0
+    // and the left one spilled to the stack
+    void combine(const BinaryASTNode& node, ASTNode::Type type) {
+        if (isLeaf(node.getRight())) {
+            loadLeaf(1, node.getRight());
+        } else {
+            emit({0x66, 0x0F, 0x28, 0xC8});       // movapd xmm1, xmm0
+            emit({0xF2, 0x0F, 0x10, 0x04, 0x24}); // movsd xmm0, [rsp]
+            emit({0x48, 0x83, 0xC4, 0x08});       // add rsp, 8
+            --depth;
+        }
+
+        switch (type) {
+            case ASTNode::Type::Add: emit({0xF2, 0x0F, 0x58, 0xC1}); return;      // addsd xmm0, xmm1
+            case ASTNode::Type::Subtract: emit({0xF2, 0x0F, 0x5C, 0xC1}); return; // subsd xmm0, xmm1
+            case ASTNode::Type::Multiply: emit({0xF2, 0x0F, 0x59, 0xC1}); return; // mulsd xmm0, xmm1
+            case ASTNode::Type::Divide:
+                // Divide::evaluate yields 0 for a zero divisor, so mask the quotient
+                emit({0xF2, 0x0F, 0x5E, 0xC1});       // divsd xmm0, xmm1
+                emit({0x66, 0x0F, 0x57, 0xD2});       // xorpd xmm2, xmm2
+                emit({0xF2, 0x0F, 0xC2, 0xD1, 0x04}); // cmpneqsd xmm2, xmm1
+                emit({0x66, 0x0F, 0x54, 0xC2});       // andpd xmm0, xmm2
+                return;
+            default: callPowFunction(); return;
+        }
+    }
+
+    // xmm0 = xmm0 ^ exponent by square-and-multiply
+    void integerPower(int64_t exponent) {
+        uint64_t remaining = static_cast<uint64_t>(exponent < 0 ? -exponent : exponent);
+        emit({0x66, 0x0F, 0x28, 0xD0}); // movapd xmm2, xmm0
+        loadConstant(1, 1.0);
+        while (remaining) {
+            if (remaining & 1) emit({0xF2, 0x0F, 0x59, 0xCA}); // mulsd xmm1, xmm2
+            remaining >>= 1;
+            if (remaining) emit({0xF2, 0x0F, 0x59, 0xD2}); // mulsd xmm2, xmm2
+        }
+        if (exponent < 0) {
+            loadConstant(0, 1.0);
+            emit({0xF2, 0x0F, 0x5E, 0xC1}); // divsd xmm0, xmm1
+        } else {
+            emit({0x66, 0x0F, 0x28, 0xC1}); // movapd xmm0, xmm1
+        }
+    }
+
+    void callPowFunction() {
+        // The stack is 16 byte aligned after the prologue; keep it that way
+        bool pad = depth % 2 != 0;
+        if (pad) emit({0x48, 0x83, 0xEC, 0x08}); // sub rsp, 8
+        emit({0x48, 0xB8});                      // mov rax, imm64
+        emitImmediate(reinterpret_cast<uint64_t>(&callPow), 8);
+        emit({0xFF, 0xD0}); // call rax
+        if (pad) emit({0x48, 0x83, 0xC4, 0x08}); // add rsp, 8
+    }
+};
+
+} // namespace
+
+// --- CompiledExpression --------------------------------------------------
+CompiledExpression::CompiledExpression(ASTNode& root, size_t parameterCount)
+    : tree(&root), parameterCount(parameterCount) {}
+
+CompiledExpression CompiledExpression::interpret(ASTNode& root) {
+    return CompiledExpression(root, requiredParameterCount(root));
+}
+
+CompiledExpression CompiledExpression::compile(ASTNode& root) {
+    CompiledExpression result = interpret(root);
+#if defined(__x86_64__)
+    // Parameter offsets are encoded as 32 bit displacements
+    if (result.parameterCount > static_cast<size_t>(std::numeric_limits<int32_t>::max()) / sizeof(double))
+        return result;
+
+    Emitter emitter;
+    emitter.prologue();
+    emitter.generate(root);
+    emitter.epilogue();
+    if (emitter.getMaxDepth() > maxSpillDepth) return result;
+    try {
+        result.code = CodeBuffer(emitter.code);
+    } catch (const std::runtime_error&) {
+        return result;
+    }
+    result.function = reinterpret_cast<Function>(const_cast<void*>(result.code.data()));
+#endif
+    return result;
+}
+
+bool CompiledExpression::isNative() const { return function != nullptr; }
+CompiledExpression::Function CompiledExpression::getFunction() const { return function; }
+size_t CompiledExpression::getParameterCount() const { return parameterCount; }
+
+double CompiledExpression::evaluate(const double* parameters) const {
+    if (function) return function(parameters);
+
+    EvaluationContext ctx(std::span<const double>(parameters, parameterCount));
+    return evaluateIteratively(*tree, ctx);
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
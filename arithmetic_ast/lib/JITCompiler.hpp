@@ -0,0 +1,68 @@
+#ifndef H_lib_JITCompiler
+#define H_lib_JITCompiler
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// Owns a page-aligned executable memory region holding generated code
+class CodeBuffer {
+public:
+    CodeBuffer() = default;
+    // Copies code into a fresh mapping and makes it read-only + executable.
+    // Throws std::runtime_error if the system refuses executable memory.
+    explicit CodeBuffer(const std::vector<uint8_t>& code);
+    ~CodeBuffer();
+
+    CodeBuffer(const CodeBuffer&) = delete;
+    CodeBuffer& operator=(const CodeBuffer&) = delete;
+    CodeBuffer(CodeBuffer&& other) noexcept;
+    CodeBuffer& operator=(CodeBuffer&& other) noexcept;
+
+    const void* data() const;
+    size_t size() const;
+
+private:
+    void* memory = nullptr;
+    size_t length = 0;
+};
+
+// An expression compiled to native x86-64 code, or the interpreter fallback.
+// The generated function reads parameter i from parameters[i]. It stays valid
+// as long as the owning CompiledExpression is alive; the interpreter fallback
+// additionally requires the source tree to stay alive.
+class CompiledExpression {
+public:
+    using Function = double (*)(const double* parameters);
+
+    // Compile root (callers should optimize it first). Falls back to the tree
+    // interpreter on other architectures, when executable memory is
+    // unavailable, or when the generated code would need too much machine
+    // stack for deeply nested right operands. Trees of any depth compile
+    // without recursion.
+    static CompiledExpression compile(ASTNode& root);
+    // Always use the tree interpreter (evaluateIteratively)
+    static CompiledExpression interpret(ASTNode& root);
+
+    bool isNative() const;
+    // The native entry point, nullptr when interpreting
+    Function getFunction() const;
+    // Number of values the parameters array must provide
+    size_t getParameterCount() const;
+    double evaluate(const double* parameters) const;
+
+private:
+    CompiledExpression(ASTNode& root, size_t parameterCount);
+
+    ASTNode* tree;
+    size_t parameterCount;
+    CodeBuffer code;
+    Function function = nullptr;
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
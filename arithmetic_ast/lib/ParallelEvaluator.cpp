@@ -0,0 +1,118 @@
+#include "lib/ParallelEvaluator.hpp"
+#include "lib/EvaluationContext.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+namespace {
+
+double identity(ParallelEvaluator::Reduction reduction) {
+    switch (reduction) {
+        case ParallelEvaluator::Reduction::Min: return std::numeric_limits<double>::infinity();
+        case ParallelEvaluator::Reduction::Max: return -std::numeric_limits<double>::infinity();
+        default: return 0.0;
+    }
+}
+
+double combine(ParallelEvaluator::Reduction reduction, double a, double b) {
+    switch (reduction) {
+        case ParallelEvaluator::Reduction::Min: return std::min(a, b);
+        case ParallelEvaluator::Reduction::Max: return std::max(a, b);
+        default: return a + b;
+    }
+}
+
+void checkShape(std::span<const double> rows, size_t rowWidth, size_t numRows, size_t parameterCount) {
+    if (rowWidth < parameterCount) throw std::out_of_range("Row width too small for the expression");
+    if (rows.size() < numRows * rowWidth) throw std::out_of_range("Not enough rows for the requested output");
+}
+
+} // namespace
+
+ParallelEvaluator::ParallelEvaluator(ThreadPool& pool, size_t chunkRows) : pool(pool), chunkRows(chunkRows) {}
+
+size_t ParallelEvaluator::rowsPerChunk(size_t rowWidth) const {
+    if (chunkRows) return chunkRows;
+    return std::max<size_t>(1, defaultChunkBytes / (std::max<size_t>(1, rowWidth) * sizeof(double)));
+}
+
+template <typename Kernel>
+void ParallelEvaluator::run(size_t numRows, size_t rowWidth, const Kernel& kernel) {
+    size_t perChunk = rowsPerChunk(rowWidth);
+    size_t numChunks = (numRows + perChunk - 1) / perChunk;
+    pool.parallelFor(numChunks, [&](size_t chunk, unsigned slot) {
+        size_t begin = chunk * perChunk;
+        size_t end = std::min(numRows, begin + perChunk);
+        kernel(chunk, begin, end, slot);
+    });
+}
+
+void ParallelEvaluator::evaluate(ASTNode& root, std::span<const double> rows, size_t rowWidth, std::span<double> out) {
+    checkShape(rows, rowWidth, out.size(), requiredParameterCount(root));
+    if (out.empty()) return;
+
+    // Validate once, then hand every slot its own copy of the context
+    EvaluationContext prototype(rows.first(rowWidth));
+    prototype.validate(root);
+    std::vector<EvaluationContext> contexts(pool.size(), prototype);
+
+    run(out.size(), rowWidth, [&](size_t, size_t begin, size_t end, unsigned slot) {
+        EvaluationContext& ctx = contexts[slot];
+        for (size_t r = begin; r < end; ++r) {
+            ctx.bind(rows.subspan(r * rowWidth, rowWidth));
+            out[r] = root.evaluate(ctx);
+        }
+    });
+}
+
+void ParallelEvaluator::evaluate(const CompiledExpression& expression, std::span<const double> rows, size_t rowWidth, std::span<double> out) {
+    checkShape(rows, rowWidth, out.size(), expression.getParameterCount());
+    run(out.size(), rowWidth, [&](size_t, size_t begin, size_t end, unsigned) {
+        for (size_t r = begin; r < end; ++r) out[r] = expression.evaluate(rows.data() + r * rowWidth);
+    });
+}
+
+double ParallelEvaluator::reduce(ASTNode& root, std::span<const double> rows, size_t rowWidth, size_t numRows, Reduction reduction) {
+    checkShape(rows, rowWidth, numRows, requiredParameterCount(root));
+    if (numRows == 0) return identity(reduction);
+
+    EvaluationContext prototype(rows.first(rowWidth));
+    prototype.validate(root);
+    std::vector<EvaluationContext> contexts(pool.size(), prototype);
+    std::vector<double> partials((numRows + rowsPerChunk(rowWidth) - 1) / rowsPerChunk(rowWidth), identity(reduction));
+
+    run(numRows, rowWidth, [&](size_t chunk, size_t begin, size_t end, unsigned slot) {
+        EvaluationContext& ctx = contexts[slot];
+        double acc = identity(reduction);
+        for (size_t r = begin; r < end; ++r) {
+            ctx.bind(rows.subspan(r * rowWidth, rowWidth));
+            acc = combine(reduction, acc, root.evaluate(ctx));
+        }
+        partials[chunk] = acc;
+    });
+
+    double result = identity(reduction);
+    for (double partial : partials) result = combine(reduction, result, partial);
+    return result;
+}
+
+double ParallelEvaluator::reduce(const CompiledExpression& expression, std::span<const double> rows, size_t rowWidth, size_t numRows, Reduction reduction) {
+    checkShape(rows, rowWidth, numRows, expression.getParameterCount());
+    std::vector<double> partials((numRows + rowsPerChunk(rowWidth) - 1) / rowsPerChunk(rowWidth), identity(reduction));
+
+    run(numRows, rowWidth, [&](size_t chunk, size_t begin, size_t end, unsigned) {
+        double acc = identity(reduction);
+        for (size_t r = begin; r < end; ++r) acc = combine(reduction, acc, expression.evaluate(rows.data() + r * rowWidth));
+        partials[chunk] = acc;
+    });
+
+    double result = identity(reduction);
+    for (double partial : partials) result = combine(reduction, result, partial);
+    return result;
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
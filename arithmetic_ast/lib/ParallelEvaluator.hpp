@@ -0,0 +1,47 @@
+#ifndef H_lib_ParallelEvaluator
+#define H_lib_ParallelEvaluator
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/JITCompiler.hpp"
+#include "lib/ThreadPool.hpp"
+#include <cstddef>
+#include <span>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// Evaluates one expression over many rows of parameters on a thread pool.
+// rows is row-major with rowWidth values per row; the number of rows is
+// taken from the output span. Rows are split into chunks whose inputs fit
+// into the per-core cache, and every pool slot uses its own context.
+class ParallelEvaluator {
+public:
+    enum class Reduction { Sum, Min, Max };
+
+    // Default chunk size: rows whose parameters fill this many bytes
+    static constexpr size_t defaultChunkBytes = 256 * 1024;
+
+    // chunkRows == 0 derives the chunk size from defaultChunkBytes
+    explicit ParallelEvaluator(ThreadPool& pool, size_t chunkRows = 0);
+
+    // out[i] = value of root for row i
+    void evaluate(ASTNode& root, std::span<const double> rows, size_t rowWidth, std::span<double> out);
+    void evaluate(const CompiledExpression& expression, std::span<const double> rows, size_t rowWidth, std::span<double> out);
+
+    // Reduce the values of root over numRows rows without materialising them.
+    // Partial results are combined in chunk order, so sums do not depend on
+    // the number of threads. Min and Max of zero rows are +inf and -inf.
+    double reduce(ASTNode& root, std::span<const double> rows, size_t rowWidth, size_t numRows, Reduction reduction);
+    double reduce(const CompiledExpression& expression, std::span<const double> rows, size_t rowWidth, size_t numRows, Reduction reduction);
+
+private:
+    ThreadPool& pool;
+    size_t chunkRows;
+
+    size_t rowsPerChunk(size_t rowWidth) const;
+    template <typename Kernel>
+    void run(size_t numRows, size_t rowWidth, const Kernel& kernel);
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,215 @@
+#ifndef H_lib_ScalarEvaluator
+#define H_lib_ScalarEvaluator
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/FlatExpression.hpp"
+#include "lib/Complex.hpp"
+#include "lib/Rational.hpp"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+//---------------------------------------------------------------------------
+// Evaluation of an expression with a scalar type other than double, e.g.
+// float for twice as many SIMD lanes in batch mode, or arithmetic::Complex
+// and arithmetic::Rational for complex-valued and exact formulas. All
+// operators keep the semantics of ASTNode::evaluate, including x / 0 == 0.
+//---------------------------------------------------------------------------
+namespace ast {
+
+// How constants of the tree map to a scalar type and which exponents count as
+// integral. Specialised below for floating point, Complex and Rational.
+template <typename T>
+struct ScalarTraits;
+
+template <std::floating_point T>
+struct ScalarTraits<T> {
+    static T fromConstant(double value) { return static_cast<T>(value); }
+    static std::optional<long long> integralExponent(T value) {
+        if (value != std::trunc(value) || std::abs(value) > static_cast<T>(INT64_MAX / 2)) return std::nullopt;
+        return static_cast<long long>(value);
+    }
+};
+
+template <>
+struct ScalarTraits<arithmetic::Complex> {
+    static arithmetic::Complex fromConstant(double value) { return {value}; }
+    static std::optional<long long> integralExponent(const arithmetic::Complex& value) {
+        if (value.imag() != 0.0) return std::nullopt;
+        return ScalarTraits<double>::integralExponent(value.real());
+    }
+};
+
+template <>
+struct ScalarTraits<arithmetic::Rational> {
+    // Exact conversion; throws std::domain_error if the value needs more than 62 bits
+    static arithmetic::Rational fromConstant(double value) {
+        if (!std::isfinite(value)) throw std::domain_error("Constant is not representable as Rational");
+        long long denominator = 1;
+        while (value != std::trunc(value)) {
+            if (denominator > (INT64_MAX >> 2)) throw std::domain_error("Constant is not representable as Rational");
+            value *= 2.0;
+            denominator *= 2;
+        }
+        if (std::abs(value) > static_cast<double>(INT64_MAX >> 1)) throw std::domain_error("Constant is not representable as Rational");
+        return {static_cast<long long>(value), denominator};
+    }
+    static std::optional<long long> integralExponent(const arithmetic::Rational& value) {
+        if (value.den() != 1) return std::nullopt;
+        return value.num();
+    }
+};
+
+// Types the evaluator can compute with
+template <typename T>
+concept Scalar = std::copyable<T> && requires(const T a, const T b, double constant) {
+    { a + b } -> std::convertible_to<T>;
+    { a - b } -> std::convertible_to<T>;
+    { a * b } -> std::convertible_to<T>;
+    { a / b } -> std::convertible_to<T>;
+    { -a } -> std::convertible_to<T>;
+    { a == b } -> std::convertible_to<bool>;
+    { ScalarTraits<T>::fromConstant(constant) } -> std::same_as<T>;
+    { ScalarTraits<T>::integralExponent(a) } -> std::same_as<std::optional<long long>>;
+};
+
+// Scalars with a power function for arbitrary exponents. All other scalars
+// only support Power with integral exponents.
+template <typename T>
+concept RealPower = Scalar<T> && requires(const T a, const T b) {
+    { std::pow(a, b) } -> std::same_as<T>;
+};
+
+template <Scalar T>
+T power(const T& base, const T& exponent) {
+    if constexpr (RealPower<T>) {
+        return std::pow(base, exponent);
+    } else {
+        auto n = ScalarTraits<T>::integralExponent(exponent);
+        if (!n) throw std::domain_error("Non-integral exponent needs a scalar type with real powers");
+        // Square and multiply
+        T result = ScalarTraits<T>::fromConstant(1.0);
+        T factor = base;
+        for (unsigned long long e = *n < 0 ? -static_cast<unsigned long long>(*n) : *n; e; e >>= 1) {
+            if (e & 1) result = result * factor;
+            if (e > 1) factor = factor * factor;
+        }
+        return *n < 0 ? ScalarTraits<T>::fromConstant(1.0) / result : result;
+    }
+}
+
+// Evaluates one expression with scalar type T, one parameter set at a time or
+// for a batch of rows. Constants are converted once on construction.
+// Evaluation reuses internal buffers and is therefore not thread-safe.
+template <Scalar T>
+class ScalarEvaluator {
+public:
+    // Rows per block in batch mode
+    static constexpr size_t batchSize = 256;
+
+    // Throws std::domain_error if a constant cannot be represented in T, or
+    // if T has no real powers and a constant exponent is not integral
+    explicit ScalarEvaluator(const ASTNode& root)
+        : expression(root), parameterCount(requiredParameterCount(root)), constants(expression.size()), zero(ScalarTraits<T>::fromConstant(0.0)) {
+        for (uint32_t i = 0; i < expression.size(); ++i) {
+            if (auto* constant = std::get_if<flat::Constant>(&expression[i])) constants[i] = ScalarTraits<T>::fromConstant(constant->value);
+            if constexpr (!RealPower<T>) {
+                auto* node = std::get_if<flat::Power>(&expression[i]);
+                if (node && expression.getType(node->right) == ASTNode::Type::Constant && !ScalarTraits<T>::integralExponent(constants[node->right]))
+                    throw std::domain_error("Non-integral exponent needs a scalar type with real powers");
+            }
+        }
+    }
+
+    size_t getParameterCount() const { return parameterCount; }
+
+    T evaluate(std::span<const T> parameters) {
+        if (parameters.size() < parameterCount) throw std::out_of_range("Index out of bounds in ScalarEvaluator");
+        values.resize(expression.size());
+        for (uint32_t i = 0; i < expression.size(); ++i) {
+            values[i] = expression.visit(i, [&](const auto& node) -> T {
+                using N = std::decay_t<decltype(node)>;
+                if constexpr (std::is_same_v<N, flat::Constant>) return constants[i];
+                else if constexpr (std::is_same_v<N, flat::Parameter>) return parameters[node.index];
+                else if constexpr (std::is_same_v<N, flat::UnaryPlus>) return values[node.input];
+                else if constexpr (std::is_same_v<N, flat::UnaryMinus>) return -values[node.input];
+                else return apply<N>(values[node.left], values[node.right]);
+            });
+        }
+        return values.back();
+    }
+
+    // out[r] = value for row r; rows is row-major with rowWidth values per
+    // row. Works node by node over blocks of batchSize rows, so the inner
+    // loops are plain array operations the compiler can vectorise.
+    void evaluateBatch(std::span<const T> rows, size_t rowWidth, std::span<T> out) {
+        if (rowWidth < parameterCount) throw std::out_of_range("Row width too small for the expression");
+        if (rows.size() < out.size() * rowWidth) throw std::out_of_range("Not enough rows for the requested output");
+        values.resize(expression.size() * batchSize);
+
+        for (size_t begin = 0; begin < out.size(); begin += batchSize) {
+            size_t count = std::min(batchSize, out.size() - begin);
+            for (uint32_t i = 0; i < expression.size(); ++i) {
+                T* result = values.data() + i * batchSize;
+                expression.visit(i, [&](const auto& node) {
+                    using N = std::decay_t<decltype(node)>;
+                    if constexpr (std::is_same_v<N, flat::Constant>) {
+                        std::fill(result, result + count, constants[i]);
+                    } else if constexpr (std::is_same_v<N, flat::Parameter>) {
+                        const T* row = rows.data() + begin * rowWidth + node.index;
+                        for (size_t r = 0; r < count; ++r) result[r] = row[r * rowWidth];
+                    } else if constexpr (std::is_same_v<N, flat::UnaryPlus>) {
+                        std::copy_n(values.data() + node.input * batchSize, count, result);
+                    } else if constexpr (std::is_same_v<N, flat::UnaryMinus>) {
+                        const T* input = values.data() + node.input * batchSize;
+                        for (size_t r = 0; r < count; ++r) result[r] = -input[r];
+                    } else {
+                        const T* left = values.data() + node.left * batchSize;
+                        const T* right = values.data() + node.right * batchSize;
+                        for (size_t r = 0; r < count; ++r) result[r] = apply<N>(left[r], right[r]);
+                    }
+                });
+            }
+            std::copy_n(values.data() + (expression.size() - 1) * batchSize, count, out.begin() + static_cast<std::ptrdiff_t>(begin));
+        }
+    }
+
+private:
+    flat::Expression expression;
+    size_t parameterCount;
+    // Converted value of every Constant node, indexed like the nodes
+    std::vector<T> constants;
+    std::vector<T> values;
+    T zero;
+
+    template <typename N>
+    T apply(const T& a, const T& b) const {
+        if constexpr (std::is_same_v<N, flat::Add>) {
+            return a + b;
+        } else if constexpr (std::is_same_v<N, flat::Subtract>) {
+            return a - b;
+        } else if constexpr (std::is_same_v<N, flat::Multiply>) {
+            return a * b;
+        } else if constexpr (std::is_same_v<N, flat::Divide>) {
+            if constexpr (std::is_floating_point_v<T>) {
+                // Divide unconditionally and select, which keeps the batch loop vectorisable
+                T quotient = a / b;
+                return b == zero ? zero : quotient;
+            } else {
+                return b == zero ? zero : a / b;
+            }
+        } else {
+            return power(a, b);
+        }
+    }
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
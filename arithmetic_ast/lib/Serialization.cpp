@@ -0,0 +1,278 @@
+#include "lib/Serialization.hpp"
+#include <bit>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// --- FormulaWriter -------------------------------------------------------
+size_t FormulaWriter::add(const ASTNode& root) {
+    encode(root);
+    offsets.push_back(nodes.size());
+    return offsets.size() - 2;
+}
+
+size_t FormulaWriter::size() const { return offsets.size() - 1; }
+
+void FormulaWriter::encodeNumber(uint64_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        nodes.push_back(value ? (byte | 0x80) : byte);
+    } while (value);
+}
+
+void FormulaWriter::encode(const ASTNode& root) {
+    // Pre-order with an explicit stack, so that deep trees do not overflow
+    // the call stack
+    std::vector<const ASTNode*> pending{&root};
+    while (!pending.empty()) {
+        const ASTNode& node = *pending.back();
+        pending.pop_back();
+        nodes.push_back(static_cast<uint8_t>(node.getType()));
+        switch (node.getType()) {
+            case ASTNode::Type::Constant: {
+                double value = static_cast<const Constant&>(node).getValue();
+                // Deduplicate by bit pattern so that 0.0 and -0.0 stay distinct
+                auto [it, inserted] = constantIndex.try_emplace(std::bit_cast<uint64_t>(value), constants.size());
+                if (inserted) constants.push_back(value);
+                encodeNumber(it->second);
+                break;
+            }
+            case ASTNode::Type::Parameter:
+                encodeNumber(static_cast<const Parameter&>(node).getIndex());
+                break;
+            case ASTNode::Type::UnaryPlus:
+                pending.push_back(&static_cast<const UnaryPlus&>(node).getInput());
+                break;
+            case ASTNode::Type::UnaryMinus:
+                pending.push_back(&static_cast<const UnaryMinus&>(node).getInput());
+                break;
+            default: {
+                auto& bin = static_cast<const BinaryASTNode&>(node);
+                pending.push_back(&bin.getRight());
+                pending.push_back(&bin.getLeft());
+                break;
+            }
+        }
+    }
+}
+
+void FormulaWriter::write(const std::string& path) const {
+    if (size() > std::numeric_limits<uint32_t>::max()) throw std::runtime_error("Too many formulas for one file");
+    FileHeader header{};
+    std::memcpy(header.magic, FileHeader::expectedMagic, sizeof(header.magic));
+    header.version = FileHeader::currentVersion;
+    header.formulaCount = static_cast<uint32_t>(size());
+    header.constantCount = constants.size();
+    header.nodeBytes = nodes.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+    out.write(reinterpret_cast<const char*>(constants.data()), static_cast<std::streamsize>(constants.size() * sizeof(double)));
+    out.write(reinterpret_cast<const char*>(nodes.data()), static_cast<std::streamsize>(nodes.size()));
+    if (!out) throw std::runtime_error("Cannot write " + path);
+}
+
+// --- MappedFormulaFile ---------------------------------------------------
+MappedFormulaFile::MappedFormulaFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        throw std::runtime_error("Not a formula file: " + path);
+    }
+    mappingSize = static_cast<size_t>(st.st_size);
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::runtime_error("Cannot map " + path);
+    }
+
+    auto* bytes = static_cast<const uint8_t*>(mapping);
+    header = reinterpret_cast<const FileHeader*>(bytes);
+    size_t available = mappingSize - sizeof(FileHeader);
+    size_t offsetBytes = (static_cast<size_t>(header->formulaCount) + 1) * sizeof(uint64_t);
+    bool valid = std::memcmp(header->magic, FileHeader::expectedMagic, sizeof(header->magic)) == 0
+        && header->version == FileHeader::currentVersion
+        && offsetBytes <= available
+        && header->constantCount <= (available - offsetBytes) / sizeof(double)
+        && header->nodeBytes == available - offsetBytes - header->constantCount * sizeof(double);
+    if (valid) {
+        offsets = reinterpret_cast<const uint64_t*>(bytes + sizeof(FileHeader));
+        constants = reinterpret_cast<const double*>(bytes + sizeof(FileHeader) + offsetBytes);
+        nodes = bytes + sizeof(FileHeader) + offsetBytes + header->constantCount * sizeof(double);
+        valid = offsets[header->formulaCount] == header->nodeBytes;
+    }
+    if (!valid) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        throw std::runtime_error("Not a formula file: " + path);
+    }
+}
+
+MappedFormulaFile::~MappedFormulaFile() {
+    if (mapping) munmap(mapping, mappingSize);
+}
+
+size_t MappedFormulaFile::size() const { return header->formulaCount; }
+
+MappedFormulaFile::Cursor MappedFormulaFile::formulaCursor(size_t formula) const {
+    if (formula >= size()) throw std::out_of_range("Formula index out of bounds");
+    uint64_t begin = offsets[formula];
+    uint64_t end = offsets[formula + 1];
+    if (begin > end || end > header->nodeBytes) throw std::runtime_error("Corrupt formula offsets");
+    return {nodes + begin, nodes + end};
+}
+
+uint8_t MappedFormulaFile::readTag(Cursor& cursor) const {
+    if (cursor.pos >= cursor.end) throw std::runtime_error("Truncated formula");
+    uint8_t tag = *cursor.pos++;
+    if (tag > static_cast<uint8_t>(ASTNode::Type::Parameter)) throw std::runtime_error("Unknown node tag");
+    return tag;
+}
+
+uint64_t MappedFormulaFile::readNumber(Cursor& cursor) const {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (cursor.pos >= cursor.end) throw std::runtime_error("Truncated formula");
+        uint8_t byte = *cursor.pos++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("Malformed number in formula");
+}
+
+double MappedFormulaFile::readConstant(Cursor& cursor) const {
+    uint64_t index = readNumber(cursor);
+    if (index >= header->constantCount) throw std::runtime_error("Constant index out of bounds");
+    return constants[index];
+}
+
+double MappedFormulaFile::evaluateNode(Cursor& cursor, const EvaluationContext& ctx) const {
+    // The stream is in pre-order: every UnaryMinus and binary node gets a
+    // frame, which collects the values of its inputs as they complete. The
+    // frames live on the heap, so a deep or hostile file cannot overflow
+    // the call stack.
+    struct Frame {
+        ASTNode::Type type;
+        bool leftDone;
+        double left;
+    };
+    std::vector<Frame> frames;
+
+    while (true) {
+        auto type = static_cast<ASTNode::Type>(readTag(cursor));
+        double value;
+        if (type == ASTNode::Type::Constant) {
+            value = readConstant(cursor);
+        } else if (type == ASTNode::Type::Parameter) {
+            // The file is not validated against ctx, check every lookup
+            uint64_t index = readNumber(cursor);
+            if (index >= ctx.size()) throw std::out_of_range("Parameter index out of bounds in formula file");
+            value = ctx.getParameter(index);
+        } else {
+            if (type != ASTNode::Type::UnaryPlus) frames.push_back({type, false, 0.0});
+            continue;
+        }
+
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            if (frame.type == ASTNode::Type::UnaryMinus) {
+                value = applyOp(frame.type, value, 0.0);
+            } else if (!frame.leftDone) {
+                frame.left = value;
+                frame.leftDone = true;
+                break;
+            } else {
+                value = applyOp(frame.type, frame.left, value);
+            }
+            frames.pop_back();
+        }
+        if (frames.empty()) return value;
+    }
+}
+
+std::unique_ptr<ASTNode> MappedFormulaFile::materializeNode(Cursor& cursor) const {
+    // Same scheme as evaluateNode, with subtrees instead of values
+    struct Frame {
+        ASTNode::Type type;
+        bool leftDone;
+        std::unique_ptr<ASTNode> left;
+    };
+    std::vector<Frame> frames;
+
+    while (true) {
+        auto type = static_cast<ASTNode::Type>(readTag(cursor));
+        std::unique_ptr<ASTNode> node;
+        if (type == ASTNode::Type::Constant) {
+            node = std::make_unique<Constant>(readConstant(cursor));
+        } else if (type == ASTNode::Type::Parameter) {
+            node = std::make_unique<Parameter>(readNumber(cursor));
+        } else {
+            frames.push_back({type, false, nullptr});
+            continue;
+        }
+
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            switch (frame.type) {
+                case ASTNode::Type::UnaryPlus: node = std::make_unique<UnaryPlus>(std::move(node)); break;
+                case ASTNode::Type::UnaryMinus: node = std::make_unique<UnaryMinus>(std::move(node)); break;
+                default:
+                    if (!frame.leftDone) {
+                        frame.left = std::move(node);
+                        frame.leftDone = true;
+                    } else {
+                        switch (frame.type) {
+                            case ASTNode::Type::Add: node = std::make_unique<Add>(std::move(frame.left), std::move(node)); break;
+                            case ASTNode::Type::Subtract: node = std::make_unique<Subtract>(std::move(frame.left), std::move(node)); break;
+                            case ASTNode::Type::Multiply: node = std::make_unique<Multiply>(std::move(frame.left), std::move(node)); break;
+                            case ASTNode::Type::Divide: node = std::make_unique<Divide>(std::move(frame.left), std::move(node)); break;
+                            default: node = std::make_unique<Power>(std::move(frame.left), std::move(node)); break;
+                        }
+                    }
+                    break;
+            }
+            if (!node) break;
+            frames.pop_back();
+        }
+        if (frames.empty()) return node;
+    }
+}
+
+double MappedFormulaFile::evaluate(size_t formula, const EvaluationContext& ctx) const {
+    Cursor cursor = formulaCursor(formula);
+    double result = evaluateNode(cursor, ctx);
+    if (cursor.pos != cursor.end) throw std::runtime_error("Trailing bytes after formula");
+    return result;
+}
+
+std::unique_ptr<ASTNode> MappedFormulaFile::materialize(size_t formula) const {
+    Cursor cursor = formulaCursor(formula);
+    auto result = materializeNode(cursor);
+    if (cursor.pos != cursor.end) throw std::runtime_error("Trailing bytes after formula");
+    return result;
+}
+
+ASTNode& MappedFormulaFile::get(size_t formula) {
+    if (formula >= size()) throw std::out_of_range("Formula index out of bounds");
+    auto& node = materialized[formula];
+    if (!node) node = materialize(formula);
+    return *node;
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
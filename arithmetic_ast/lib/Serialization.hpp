@@ -0,0 +1,102 @@
+#ifndef H_lib_Serialization
+#define H_lib_Serialization
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+//---------------------------------------------------------------------------
+// Compact binary storage for many formulas. File layout (host byte order):
+//
+//   FileHeader
+//   uint64_t offsets[formulaCount + 1]  start of every formula in the node stream
+//   double   constants[constantCount]    deduplicated constant table
+//   uint8_t  nodes[nodeBytes]            pre-order node stream
+//
+// Every node is one tag byte (ASTNode::Type) followed by a LEB128 index into
+// the constant table (Constant), a LEB128 parameter index (Parameter), or its
+// encoded inputs. All sections are 8 byte aligned so the file can be mapped
+// and used in place.
+//---------------------------------------------------------------------------
+namespace ast {
+
+struct FileHeader {
+    static constexpr char expectedMagic[8] = {'A', 'S', 'T', 'B', 'I', 'N', '\0', '\0'};
+    static constexpr uint32_t currentVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t formulaCount;
+    uint64_t constantCount;
+    uint64_t nodeBytes;
+};
+
+// Collects formulas and writes them into one binary file
+class FormulaWriter {
+public:
+    // Append a formula and return its index in the file
+    size_t add(const ASTNode& root);
+    size_t size() const;
+    // Throws std::runtime_error on I/O errors
+    void write(const std::string& path) const;
+
+private:
+    std::vector<uint64_t> offsets{0};
+    std::vector<double> constants;
+    std::unordered_map<uint64_t, uint64_t> constantIndex;
+    std::vector<uint8_t> nodes;
+
+    void encode(const ASTNode& root);
+    void encodeNumber(uint64_t value);
+};
+
+// Read-only memory mapping of a file written by FormulaWriter. Opening only
+// checks the header, so cold start cost does not depend on the file size;
+// each formula is bounds checked while it is decoded.
+class MappedFormulaFile {
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is malformed
+    explicit MappedFormulaFile(const std::string& path);
+    ~MappedFormulaFile();
+
+    MappedFormulaFile(const MappedFormulaFile&) = delete;
+    MappedFormulaFile& operator=(const MappedFormulaFile&) = delete;
+
+    size_t size() const;
+    // Evaluate a formula directly from the mapped bytes. Throws
+    // std::out_of_range if it reads a parameter ctx does not have.
+    double evaluate(size_t formula, const EvaluationContext& ctx) const;
+    // Build a fresh tree for a formula
+    std::unique_ptr<ASTNode> materialize(size_t formula) const;
+    // Materialize a formula on first access and keep it. Not thread-safe.
+    ASTNode& get(size_t formula);
+
+private:
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    const FileHeader* header = nullptr;
+    const uint64_t* offsets = nullptr;
+    const double* constants = nullptr;
+    const uint8_t* nodes = nullptr;
+    std::unordered_map<size_t, std::unique_ptr<ASTNode>> materialized;
+
+    struct Cursor {
+        const uint8_t* pos;
+        const uint8_t* end;
+    };
+
+    Cursor formulaCursor(size_t formula) const;
+    uint8_t readTag(Cursor& cursor) const;
+    uint64_t readNumber(Cursor& cursor) const;
+    double readConstant(Cursor& cursor) const;
+    double evaluateNode(Cursor& cursor, const EvaluationContext& ctx) const;
+    std::unique_ptr<ASTNode> materializeNode(Cursor& cursor) const;
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
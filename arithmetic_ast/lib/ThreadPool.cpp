@@ -0,0 +1,77 @@
+#include "lib/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <latch>
+#include <utility>
+//---------------------------------------------------------------------------
+namespace ast {
+
+ThreadPool::ThreadPool(unsigned numThreads) {
+    if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; ++i) workers.emplace_back([this] { work(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+unsigned ThreadPool::size() const { return static_cast<unsigned>(workers.size()); }
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wakeup.notify_one();
+}
+
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            wakeup.wait(lock, [this] { return stopping || !tasks.empty(); });
+            // Drain the queue before shutting down
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t numChunks, const std::function<void(size_t chunk, unsigned slot)>& body) {
+    if (numChunks == 0) return;
+    unsigned slots = static_cast<unsigned>(std::min<size_t>(size(), numChunks));
+    std::atomic<size_t> nextChunk{0};
+    std::latch done(slots);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    for (unsigned slot = 0; slot < slots; ++slot) {
+        submit([&, slot] {
+            try {
+                for (size_t chunk = nextChunk.fetch_add(1); chunk < numChunks; chunk = nextChunk.fetch_add(1))
+                    body(chunk, slot);
+            } catch (...) {
+                std::lock_guard lock(errorMutex);
+                if (!error) error = std::current_exception();
+                // Let the other slots run out of work quickly
+                nextChunk.store(numChunks);
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
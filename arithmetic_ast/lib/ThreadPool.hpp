@@ -0,0 +1,46 @@
+#ifndef H_lib_ThreadPool
+#define H_lib_ThreadPool
+//---------------------------------------------------------------------------
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// A fixed set of worker threads consuming a FIFO task queue
+class ThreadPool {
+public:
+    // Zero threads means one per hardware thread
+    explicit ThreadPool(unsigned numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const;
+    // Queue a task for asynchronous execution
+    void submit(std::function<void()> task);
+    // Call body(chunk, slot) for every chunk in [0, numChunks) and wait for all
+    // of them. Chunks are handed out dynamically to size() slots; a slot runs
+    // on one thread at a time, so per-slot state needs no locking. The first
+    // exception thrown by body is rethrown here. Must not be called from a
+    // task running on this pool.
+    void parallelFor(size_t numChunks, const std::function<void(size_t chunk, unsigned slot)>& body);
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+
+    void work();
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
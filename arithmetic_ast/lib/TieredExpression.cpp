@@ -0,0 +1,75 @@
+#include "lib/TieredExpression.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/FlatExpression.hpp"
+#include "lib/IterativeTraversal.hpp"
+#include <stdexcept>
+#include <utility>
+//---------------------------------------------------------------------------
+namespace ast {
+
+TieredExpression::TieredExpression(std::unique_ptr<ASTNode> root, ThreadPool& pool, uint64_t threshold)
+    : root(std::move(root)), pool(pool), threshold(threshold), parameterCount(requiredParameterCount(*this->root)) {
+    if (threshold == 0) startCompilation();
+}
+
+TieredExpression::~TieredExpression() {
+    waitForCompilation();
+}
+
+double TieredExpression::evaluate(std::span<const double> parameters) {
+    if (parameters.size() < parameterCount) throw std::out_of_range("Index out of bounds in TieredExpression");
+    if (const CompiledExpression* expression = compiled.load(std::memory_order_acquire)) return expression->evaluate(parameters.data());
+
+    if (evaluations.fetch_add(1, std::memory_order_relaxed) + 1 == threshold) startCompilation();
+    EvaluationContext ctx(parameters);
+    return evaluateIteratively(*root, ctx);
+}
+
+size_t TieredExpression::getParameterCount() const { return parameterCount; }
+
+TieredExpression::Tier TieredExpression::getTier() const { return tier.load(std::memory_order_acquire); }
+
+TieredExpression::Statistics TieredExpression::getStatistics() const {
+    Tier current = getTier();
+    bool ready = current == Tier::Compiled;
+    return {current, evaluations.load(std::memory_order_relaxed), ready && compiledExpression->isNative(), ready ? compileTime : std::chrono::nanoseconds(0)};
+}
+
+void TieredExpression::waitForCompilation() {
+    std::unique_lock lock(mutex);
+    finished.wait(lock, [this] { return !compiling; });
+}
+
+void TieredExpression::startCompilation() {
+    {
+        std::lock_guard lock(mutex);
+        compiling = true;
+    }
+    tier.store(Tier::Compiling, std::memory_order_release);
+    pool.submit([this] { compile(); });
+}
+
+void TieredExpression::compile() {
+    auto start = std::chrono::steady_clock::now();
+    Tier result = Tier::Compiled;
+    try {
+        // Work on a copy, other threads may still be interpreting root
+        optimizedTree = flat::Expression(*root).toTree();
+        optimizeIteratively(optimizedTree);
+        compiledExpression = std::make_unique<CompiledExpression>(CompiledExpression::compile(*optimizedTree));
+        compileTime = std::chrono::steady_clock::now() - start;
+        compiled.store(compiledExpression.get(), std::memory_order_release);
+    } catch (...) {
+        // Stay in the interpreter
+        result = Tier::Failed;
+    }
+    tier.store(result, std::memory_order_release);
+
+    // Notify under the lock: the destructor may run as soon as it is released
+    std::lock_guard lock(mutex);
+    compiling = false;
+    finished.notify_all();
+}
+
+} // namespace ast
+//---------------------------------------------------------------------------
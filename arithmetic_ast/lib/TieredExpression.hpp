@@ -0,0 +1,81 @@
+#ifndef H_lib_TieredExpression
+#define H_lib_TieredExpression
+//---------------------------------------------------------------------------
+#include "lib/AST.hpp"
+#include "lib/JITCompiler.hpp"
+#include "lib/ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+//---------------------------------------------------------------------------
+namespace ast {
+
+// Runs an expression with the tree interpreter until it has been evaluated
+// threshold times, then optimizes a copy of the tree and compiles it on a
+// thread pool. Evaluations switch to the compiled code as soon as it is
+// ready; until then they keep interpreting. Cold expressions thus never pay
+// for compilation, hot ones end up as native code. evaluate() may be called
+// from several threads at once.
+class TieredExpression {
+public:
+    enum class Tier { Interpreted, Compiling, Compiled, Failed };
+
+    struct Statistics {
+        Tier tier;
+        // Evaluations that ran in the interpreter
+        uint64_t interpretedEvaluations;
+        // Whether the compiled tier runs native code or the interpreter fallback
+        bool native;
+        // Time spent optimizing and compiling in the background
+        std::chrono::nanoseconds compileTime;
+    };
+
+    static constexpr uint64_t defaultThreshold = 1000;
+
+    // pool runs the compilation and must outlive this object. threshold == 0
+    // compiles right away.
+    TieredExpression(std::unique_ptr<ASTNode> root, ThreadPool& pool, uint64_t threshold = defaultThreshold);
+    // Waits for a running compilation
+    ~TieredExpression();
+
+    TieredExpression(const TieredExpression&) = delete;
+    TieredExpression& operator=(const TieredExpression&) = delete;
+
+    // Throws std::out_of_range if parameters has fewer than getParameterCount() values
+    double evaluate(std::span<const double> parameters);
+    size_t getParameterCount() const;
+    Tier getTier() const;
+    Statistics getStatistics() const;
+    // Block until a started compilation has finished
+    void waitForCompilation();
+
+private:
+    std::unique_ptr<ASTNode> root;
+    ThreadPool& pool;
+    uint64_t threshold;
+    size_t parameterCount;
+
+    std::atomic<uint64_t> evaluations{0};
+    std::atomic<Tier> tier{Tier::Interpreted};
+    // Published with release semantics once the compiled tier is ready
+    std::atomic<const CompiledExpression*> compiled{nullptr};
+    std::unique_ptr<ASTNode> optimizedTree;
+    std::unique_ptr<CompiledExpression> compiledExpression;
+    std::chrono::nanoseconds compileTime{0};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool compiling = false;
+
+    void startCompilation();
+    void compile();
+};
+
+} // namespace ast
+//---------------------------------------------------------------------------
+#endif
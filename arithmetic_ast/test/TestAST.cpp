@@ -62,6 +62,17 @@ TEST(TestAST, EvaluateParameter) {
     EXPECT_EQ(node->evaluate(context), 1.0);
 }
 //---------------------------------------------------------------------------
+TEST(TestAST, ApplyOp) {
+    EXPECT_EQ(applyOp(ASTNode::Type::UnaryPlus, 3.0, 5.0), 3.0);
+    EXPECT_EQ(applyOp(ASTNode::Type::UnaryMinus, 3.0, 5.0), -3.0);
+    EXPECT_EQ(applyOp(ASTNode::Type::Add, 3.0, 5.0), 8.0);
+    EXPECT_EQ(applyOp(ASTNode::Type::Subtract, 3.0, 5.0), -2.0);
+    EXPECT_EQ(applyOp(ASTNode::Type::Multiply, 3.0, 5.0), 15.0);
+    EXPECT_EQ(applyOp(ASTNode::Type::Divide, 3.0, 4.0), 0.75);
+    EXPECT_EQ(applyOp(ASTNode::Type::Divide, 3.0, 0.0), 0.0);
+    EXPECT_EQ(applyOp(ASTNode::Type::Power, 3.0, 2.0), 9.0);
+}
+//---------------------------------------------------------------------------
 TEST(TestAST, EvaluateNested) {
     EvaluationContext context;
     context.pushParameter(2.0);
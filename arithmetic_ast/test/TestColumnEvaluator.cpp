@@ -0,0 +1,115 @@
+#include "lib/AST.hpp"
+#include "lib/ColumnEvaluator.hpp"
+#include "lib/EvaluationContext.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+class TempDirectory {
+    public:
+    filesystem::path path;
+
+    TempDirectory() : path(filesystem::temp_directory_path() / ("ast_columns_" + to_string(getpid()))) { filesystem::create_directories(path); }
+    ~TempDirectory() { filesystem::remove_all(path); }
+
+    string file(const string& name) const { return (path / name).string(); }
+};
+//---------------------------------------------------------------------------
+void writeColumn(const string& path, const vector<double>& values) {
+    ofstream out(path, ios::binary);
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<streamsize>(values.size() * sizeof(double)));
+}
+//---------------------------------------------------------------------------
+vector<double> readColumn(const string& path) {
+    MappedColumn column(path);
+    return vector<double>(column.data(), column.data() + column.size());
+}
+//---------------------------------------------------------------------------
+// (P0 * P1 - -P0) / (P1 - 3) ^ 2
+unique_ptr<ASTNode> sampleTree() {
+    auto product = make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    auto numerator = make_unique<Subtract>(std::move(product), make_unique<UnaryMinus>(make_unique<Parameter>(0)));
+    auto base = make_unique<Subtract>(make_unique<Parameter>(1), make_unique<Constant>(3.0));
+    return make_unique<Divide>(std::move(numerator), make_unique<Power>(std::move(base), make_unique<Constant>(2.0)));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestColumnEvaluator, MatchesTree) {
+    TempDirectory dir;
+    constexpr size_t numRows = 10'007;
+    vector<double> p0(numRows), p1(numRows);
+    for (size_t r = 0; r < numRows; ++r) {
+        p0[r] = static_cast<double>(r) * 0.5;
+        p1[r] = static_cast<double>(r % 7);
+    }
+    writeColumn(dir.file("p0"), p0);
+    writeColumn(dir.file("p1"), p1);
+
+    auto tree = sampleTree();
+    // A block size that does not divide the number of rows
+    ColumnEvaluator evaluator(*tree, 1000);
+    EXPECT_EQ(evaluator.run({dir.file("p0"), dir.file("p1")}, dir.file("out")), numRows);
+
+    auto results = readColumn(dir.file("out"));
+    ASSERT_EQ(results.size(), numRows);
+    for (size_t r = 0; r < numRows; ++r) {
+        vector<double> params{p0[r], p1[r]};
+        EvaluationContext context(params);
+        ASSERT_EQ(results[r], tree->evaluate(context)) << r;
+    }
+    // P1 == 3 divides by zero
+    EXPECT_EQ(results[3], 0.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestColumnEvaluator, LeafRoots) {
+    TempDirectory dir;
+    writeColumn(dir.file("p0"), {1.0, 2.0, 3.0});
+    writeColumn(dir.file("p1"), {4.0, 5.0, 6.0});
+
+    Parameter parameter(1);
+    ColumnEvaluator(parameter, 2).run({dir.file("p0"), dir.file("p1")}, dir.file("out"));
+    EXPECT_EQ(readColumn(dir.file("out")), (vector<double>{4.0, 5.0, 6.0}));
+
+    UnaryPlus constant(make_unique<Constant>(7.0));
+    ColumnEvaluator(constant).run({dir.file("p0")}, dir.file("out"));
+    EXPECT_EQ(readColumn(dir.file("out")), (vector<double>{7.0, 7.0, 7.0}));
+}
+//---------------------------------------------------------------------------
+TEST(TestColumnEvaluator, EmptyColumns) {
+    TempDirectory dir;
+    writeColumn(dir.file("p0"), {});
+    Add add(make_unique<Parameter>(0), make_unique<Constant>(1.0));
+    EXPECT_EQ(ColumnEvaluator(add).run({dir.file("p0")}, dir.file("out")), 0u);
+    EXPECT_EQ(filesystem::file_size(dir.file("out")), 0u);
+}
+//---------------------------------------------------------------------------
+TEST(TestColumnEvaluator, RejectsBadInput) {
+    TempDirectory dir;
+    writeColumn(dir.file("p0"), {1.0, 2.0});
+    writeColumn(dir.file("p1"), {1.0});
+    {
+        ofstream out(dir.file("odd"), ios::binary);
+        out << "12345";
+    }
+    Add add(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    ColumnEvaluator evaluator(add);
+    EXPECT_THROW(evaluator.run({dir.file("p0")}, dir.file("out")), out_of_range);
+    EXPECT_THROW(evaluator.run({dir.file("p0"), dir.file("p1")}, dir.file("out")), runtime_error);
+    EXPECT_THROW(evaluator.run({dir.file("p0"), dir.file("odd")}, dir.file("out")), runtime_error);
+    EXPECT_THROW(evaluator.run({dir.file("p0"), dir.file("missing")}, dir.file("out")), runtime_error);
+    EXPECT_THROW(evaluator.run({dir.file("p0"), dir.file("p0")}, dir.file("missing/out")), runtime_error);
+}
+//---------------------------------------------------------------------------
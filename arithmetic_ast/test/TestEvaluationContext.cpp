@@ -0,0 +1,93 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+TEST(TestEvaluationContext, PushParameter) {
+    EvaluationContext context;
+    context.pushParameter(1.0);
+    context.pushParameter(2.0);
+    EXPECT_EQ(context.size(), 2);
+    EXPECT_EQ(context.getParameter(1), 2.0);
+    EXPECT_THROW(context.getParameter(2), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestEvaluationContext, BindWithoutCopy) {
+    vector<double> row{1.0, 2.0, 3.0};
+    EvaluationContext context(row);
+    EXPECT_EQ(context.size(), 3);
+    EXPECT_EQ(context.getParameter(2), 3.0);
+    row[2] = 4.0;
+    EXPECT_EQ(context.getParameter(2), 4.0);
+    EXPECT_THROW(context.getParameter(3), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestEvaluationContext, RebindRows) {
+    // P0 * P1 over three rows of two parameters
+    vector<double> rows{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    auto node = make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    EvaluationContext context(span<const double>(rows).subspan(0, 2));
+    context.validate(*node);
+    vector<double> results;
+    for (size_t r = 0; r < 3; ++r) {
+        context.bind(span<const double>(rows).subspan(r * 2, 2));
+        results.push_back(node->evaluate(context));
+    }
+    EXPECT_EQ(results, (vector<double>{2.0, 12.0, 30.0}));
+}
+//---------------------------------------------------------------------------
+TEST(TestEvaluationContext, ValidateRejectsShortRow) {
+    vector<double> row{1.0};
+    auto node = make_unique<Add>(make_unique<Parameter>(0), make_unique<Parameter>(3));
+    EvaluationContext context(row);
+    EXPECT_THROW(context.validate(*node), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestEvaluationContext, BindRejectsShortRowAfterValidate) {
+    vector<double> rows{1.0, 2.0, 3.0};
+    auto node = make_unique<Parameter>(1);
+    EvaluationContext context(span<const double>(rows).subspan(0, 2));
+    context.validate(*node);
+    EXPECT_THROW(context.bind(span<const double>(rows).subspan(2, 1)), out_of_range);
+}
+//---------------------------------------------------------------------------
+#ifndef NDEBUG
+TEST(TestEvaluationContext, DebugChecksUnvalidatedTree) {
+    // P1 is bound, but the context was only validated for P0
+    vector<double> row{1.0, 2.0};
+    auto validated = make_unique<Parameter>(0);
+    auto other = make_unique<Parameter>(1);
+    EvaluationContext context(row);
+    context.validate(*validated);
+    EXPECT_EQ(validated->evaluate(context), 1.0);
+    EXPECT_THROW(other->evaluate(context), out_of_range);
+}
+#endif
+//---------------------------------------------------------------------------
+TEST(TestEvaluationContext, PushAfterBindCopiesRow) {
+    vector<double> row{1.0, 2.0};
+    EvaluationContext context(row);
+    context.pushParameter(3.0);
+    row[0] = 10.0;
+    EXPECT_EQ(context.size(), 3);
+    EXPECT_EQ(context.getParameter(0), 1.0);
+    EXPECT_EQ(context.getParameter(2), 3.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestEvaluationContext, CopyOwnsStorage) {
+    auto copy = [] {
+        EvaluationContext context;
+        context.pushParameter(5.0);
+        EvaluationContext result(context);
+        return result;
+    }();
+    EXPECT_EQ(copy.getParameter(0), 5.0);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,122 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/ExpressionTemplates.hpp"
+#include "lib/PrintVisitor.hpp"
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace ast::expr;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+string print(ASTNode& node) {
+    stringstream stream;
+    auto* sbuf = cout.rdbuf(stream.rdbuf());
+    PrintVisitor visitor;
+    node.accept(visitor);
+    cout.rdbuf(sbuf);
+    return stream.str();
+}
+//---------------------------------------------------------------------------
+// Optimize E at compile time and its runtime tree with ASTNode::optimize,
+// both results must print identically
+template <typename E>
+void expectSameOptimization() {
+    unique_ptr<ASTNode> runtime = E::toAST();
+    runtime->optimize(runtime);
+    auto compileTime = Optimized<E>::toAST();
+    EXPECT_EQ(print(*compileTime), print(*runtime));
+}
+//---------------------------------------------------------------------------
+constexpr auto p0 = parameter<0>;
+constexpr auto p1 = parameter<1>;
+constexpr auto zero = constant<0.0>;
+constexpr auto one = constant<1.0>;
+constexpr auto two = constant<2.0>;
+//---------------------------------------------------------------------------
+// Whether E can be evaluated in a constant expression
+template <typename E>
+concept ConstexprEvaluable = requires { typename integral_constant<double, E::evaluate(array<double, 0>{})>; };
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestExpressionTemplates, OperatorsBuildTypes) {
+    auto e = p0 + two * p1;
+    static_assert(is_same_v<decltype(e), expr::Add<expr::Parameter<0>, expr::Multiply<expr::Constant<2.0>, expr::Parameter<1>>>>);
+    static_assert(decltype(e)::parameterCount == 2);
+}
+//---------------------------------------------------------------------------
+TEST(TestExpressionTemplates, ConstexprEvaluate) {
+    using E = decltype(pow((p0 + p1) * (p1 - p0) / two, two));
+    constexpr array<double, 2> params{2.0, 4.0};
+    static_assert(E::evaluate(params) == 36.0);
+    static_assert(decltype(-p0 + +p1)::evaluate(params) == 2.0);
+    static_assert(decltype(p0 / zero)::evaluate(params) == 0.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestExpressionTemplates, ConstexprPower) {
+    static_assert(decltype(pow(two, constant<10.0>))::evaluate(array<double, 0>{}) == 1024.0);
+    static_assert(decltype(pow(two, constant<-2.0>))::evaluate(array<double, 0>{}) == 0.25);
+    // far beyond the step limit of a loop over the exponent
+    static_assert(decltype(pow(one, constant<1e18>))::evaluate(array<double, 0>{}) == 1.0);
+    // fractional exponents do not compile instead of being truncated
+    using Root = decltype(pow(two, constant<0.5>));
+    static_assert(!ConstexprEvaluable<Root>);
+    static_assert(ConstexprEvaluable<decltype(pow(two, two))>);
+    EXPECT_DOUBLE_EQ(Root::evaluate(array<double, 0>{}), sqrt(2.0));
+    static_assert(is_same_v<Optimized<Root>, Root>);
+}
+//---------------------------------------------------------------------------
+TEST(TestExpressionTemplates, MatchesRuntimeEvaluate) {
+    using E = decltype(pow(p0, constant<0.5>) - p1 / (p0 + one) * -p1);
+    vector<double> params{2.25, 3.0};
+    EvaluationContext context(params);
+    auto tree = E::toAST();
+    EXPECT_DOUBLE_EQ(E::evaluate(params), tree->evaluate(context));
+    EXPECT_DOUBLE_EQ(E::evaluate(params.data()), tree->evaluate(context));
+}
+//---------------------------------------------------------------------------
+TEST(TestExpressionTemplates, ToASTPrints) {
+    auto tree = decltype(p0 * (p1 + two))::toAST();
+    EXPECT_EQ(print(*tree), "(P0 * (P1 + 2))");
+}
+//---------------------------------------------------------------------------
+TEST(TestExpressionTemplates, OptimizeRules) {
+    static_assert(is_same_v<Optimized<decltype(+p0)>, expr::Parameter<0>>);
+    static_assert(is_same_v<Optimized<decltype(-(-p0))>, expr::Parameter<0>>);
+    static_assert(is_same_v<Optimized<decltype(p0 + zero)>, expr::Parameter<0>>);
+    static_assert(is_same_v<Optimized<decltype(p0 * one)>, expr::Parameter<0>>);
+    static_assert(is_same_v<Optimized<decltype(pow(p0, one))>, expr::Parameter<0>>);
+    static_assert(is_same_v<Optimized<decltype(p0 / one)>, expr::Parameter<0>>);
+    static_assert(is_same_v<Optimized<decltype(pow(two, constant<3.0>))>, expr::Constant<8.0>>);
+    static_assert(is_same_v<Optimized<decltype(p0 * zero)>, expr::Constant<0.0>>);
+    static_assert(is_same_v<Optimized<decltype(p0 / two)>, expr::Multiply<expr::Parameter<0>, expr::Constant<0.5>>>);
+}
+//---------------------------------------------------------------------------
+TEST(TestExpressionTemplates, OptimizeMatchesRuntime) {
+    expectSameOptimization<decltype(-(p0 - p1))>();
+    expectSameOptimization<decltype(-(-p0 - p1))>();
+    expectSameOptimization<decltype(-p0 + p1)>();
+    expectSameOptimization<decltype(p0 + -p1)>();
+    expectSameOptimization<decltype(zero - p0)>();
+    expectSameOptimization<decltype(p0 - -p1)>();
+    expectSameOptimization<decltype(-p0 * -p1)>();
+    expectSameOptimization<decltype(-p0 / -p1)>();
+    expectSameOptimization<decltype(p0 / p1)>();
+    expectSameOptimization<decltype(pow(p0, constant<-1.0>))>();
+    expectSameOptimization<decltype(pow(zero, p0))>();
+    expectSameOptimization<decltype(+(+(p0 + zero)))>();
+    expectSameOptimization<decltype(pow(p0, one) + one * -p1)>();
+    expectSameOptimization<decltype(-(-p0) + p1 / one)>();
+    expectSameOptimization<decltype(pow(two * constant<3.0> + p0, two))>();
+}
+//---------------------------------------------------------------------------
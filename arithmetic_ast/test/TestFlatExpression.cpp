@@ -0,0 +1,113 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/FlatExpression.hpp"
+#include "lib/PrintVisitor.hpp"
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+string printTree(ASTNode& node) {
+    stringstream stream;
+    auto* sbuf = cout.rdbuf(stream.rdbuf());
+    PrintVisitor visitor;
+    node.accept(visitor);
+    cout.rdbuf(sbuf);
+    return stream.str();
+}
+//---------------------------------------------------------------------------
+string printFlat(const flat::Expression& expression) {
+    stringstream stream;
+    expression.print(stream);
+    return stream.str();
+}
+//---------------------------------------------------------------------------
+// -((P0 + 2) / +(P1)) ^ (P0 * -0)
+unique_ptr<ASTNode> sampleTree() {
+    auto sum = make_unique<Add>(make_unique<Parameter>(0), make_unique<Constant>(2.0));
+    auto quotient = make_unique<Divide>(std::move(sum), make_unique<UnaryPlus>(make_unique<Parameter>(1)));
+    auto product = make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Constant>(-0.0));
+    auto power = make_unique<Power>(std::move(quotient), std::move(product));
+    auto node = make_unique<Subtract>(make_unique<UnaryMinus>(std::move(power)), make_unique<Parameter>(1));
+    return node;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestFlatExpression, Layout) {
+    auto tree = sampleTree();
+    flat::Expression expression(*tree);
+    ASSERT_EQ(expression.size(), 13u);
+    EXPECT_EQ(expression.getType(expression.root()), ASTNode::Type::Subtract);
+    EXPECT_EQ(sizeof(flat::Node), 16u);
+
+    // Every input precedes the node using it
+    for (uint32_t i = 0; i < expression.size(); ++i) {
+        expression.visit(i, [i](const auto& node) {
+            using T = decay_t<decltype(node)>;
+            if constexpr (is_same_v<T, flat::UnaryPlus> || is_same_v<T, flat::UnaryMinus>) {
+                EXPECT_LT(node.input, i);
+            } else if constexpr (!is_same_v<T, flat::Constant> && !is_same_v<T, flat::Parameter>) {
+                EXPECT_LT(node.left, i);
+                EXPECT_LT(node.right, i);
+            }
+        });
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestFlatExpression, Evaluate) {
+    auto tree = sampleTree();
+    flat::Expression expression(*tree);
+    vector<double> params{1.0, 3.0};
+    EvaluationContext context(params);
+    EXPECT_EQ(expression.evaluate(context), tree->evaluate(context));
+
+    vector<double> scratch;
+    params[1] = 0.0;
+    EXPECT_EQ(expression.evaluate(context, scratch), tree->evaluate(context));
+    EXPECT_EQ(scratch.size(), expression.size());
+}
+//---------------------------------------------------------------------------
+TEST(TestFlatExpression, RoundTrip) {
+    auto tree = sampleTree();
+    flat::Expression expression(*tree);
+    EXPECT_EQ(printFlat(expression), printTree(*tree));
+
+    auto converted = expression.toTree();
+    EXPECT_EQ(printTree(*converted), printTree(*tree));
+    // Signed zero survives the conversion
+    flat::Expression again(*converted);
+    auto& product = get<flat::Multiply>(again[again.size() - 5]);
+    EXPECT_TRUE(signbit(get<flat::Constant>(again[product.right]).value));
+}
+//---------------------------------------------------------------------------
+TEST(TestFlatExpression, CustomVisitor) {
+    auto tree = sampleTree();
+    flat::Expression expression(*tree);
+    size_t parameters = 0;
+    for (uint32_t i = 0; i < expression.size(); ++i)
+        parameters += expression.visit(i, [](const auto& node) { return is_same_v<decay_t<decltype(node)>, flat::Parameter>; });
+    EXPECT_EQ(parameters, 4u);
+}
+//---------------------------------------------------------------------------
+TEST(TestFlatExpression, DeepChain) {
+    unique_ptr<ASTNode> tree = make_unique<Parameter>(0);
+    for (int i = 0; i < 1'000'000; ++i) tree = make_unique<Add>(std::move(tree), make_unique<Constant>(1.0));
+    flat::Expression expression(*tree);
+    vector<double> params{0.5};
+    EvaluationContext context(params);
+    EXPECT_EQ(expression.evaluate(context), 1'000'000.5);
+
+    auto converted = expression.toTree();
+    EXPECT_EQ(flat::Expression(*converted).size(), expression.size());
+}
+//---------------------------------------------------------------------------
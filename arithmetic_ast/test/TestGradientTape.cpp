@@ -0,0 +1,149 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/GradientTape.hpp"
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+EvaluationContext makeContext(const vector<double>& params) {
+    EvaluationContext context;
+    for (double p : params) context.pushParameter(p);
+    return context;
+}
+//---------------------------------------------------------------------------
+unique_ptr<ASTNode> fittingExpression() {
+    // P0 * P2 ^ 2 - P1 / P2 + (-P0)
+    unique_ptr<ASTNode> square = make_unique<Power>(make_unique<Parameter>(2), make_unique<Constant>(2.0));
+    unique_ptr<ASTNode> node = make_unique<Multiply>(make_unique<Parameter>(0), std::move(square));
+    node = make_unique<Subtract>(std::move(node), make_unique<Divide>(make_unique<Parameter>(1), make_unique<Parameter>(2)));
+    return make_unique<Add>(std::move(node), make_unique<UnaryMinus>(make_unique<Parameter>(0)));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, Constant) {
+    EvaluationContext context;
+    Constant c(3.0);
+    vector<double> grad;
+    EXPECT_EQ(evaluateWithGradient(c, context, grad), 3.0);
+    EXPECT_TRUE(grad.empty());
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, SharedParameter) {
+    // P0 * P0 + P0 -> 2 * P0 + 1
+    auto context = makeContext({3.0});
+    unique_ptr<ASTNode> node = make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Parameter>(0));
+    node = make_unique<Add>(std::move(node), make_unique<UnaryPlus>(make_unique<Parameter>(0)));
+    vector<double> grad;
+    EXPECT_EQ(evaluateWithGradient(*node, context, grad), 12.0);
+    ASSERT_EQ(grad.size(), 1);
+    EXPECT_EQ(grad[0], 7.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, AllOperators) {
+    vector<double> params{1.5, 2.0, 3.0};
+    auto context = makeContext(params);
+    auto node = fittingExpression();
+    vector<double> grad;
+    double value = evaluateWithGradient(*node, context, grad);
+    EXPECT_DOUBLE_EQ(value, node->evaluate(context));
+    ASSERT_EQ(grad.size(), 3);
+    EXPECT_DOUBLE_EQ(grad[0], 9.0 - 1.0);
+    EXPECT_DOUBLE_EQ(grad[1], -1.0 / 3.0);
+    EXPECT_DOUBLE_EQ(grad[2], 2 * 1.5 * 3.0 + 2.0 / 9.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, PowerExponent) {
+    // P0 ^ P1
+    auto context = makeContext({2.0, 3.0});
+    auto node = make_unique<Power>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    vector<double> grad;
+    EXPECT_DOUBLE_EQ(evaluateWithGradient(*node, context, grad), 8.0);
+    EXPECT_DOUBLE_EQ(grad[0], 12.0);
+    EXPECT_DOUBLE_EQ(grad[1], 8.0 * log(2.0));
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, DivideByZero) {
+    auto context = makeContext({1.0, 0.0});
+    auto node = make_unique<Divide>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    vector<double> grad;
+    EXPECT_EQ(evaluateWithGradient(*node, context, grad), 0.0);
+    EXPECT_EQ(grad[0], 0.0);
+    EXPECT_EQ(grad[1], 0.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, MatchesFiniteDifferences) {
+    vector<double> params{0.7, -1.2, 2.5};
+    auto node = fittingExpression();
+    auto context = makeContext(params);
+    vector<double> grad;
+    evaluateWithGradient(*node, context, grad);
+    for (size_t i = 0; i < params.size(); ++i) {
+        SCOPED_TRACE(i);
+        const double h = 1e-6;
+        auto up = params;
+        auto down = params;
+        up[i] += h;
+        down[i] -= h;
+        auto upContext = makeContext(up);
+        auto downContext = makeContext(down);
+        double numeric = (node->evaluate(upContext) - node->evaluate(downContext)) / (2 * h);
+        EXPECT_NEAR(grad[i], numeric, 1e-6);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, Replay) {
+    auto node = fittingExpression();
+    GradientTape tape(*node, makeContext({1.0, 1.0, 1.0}));
+    vector<double> params{1.5, 2.0, 3.0};
+    auto context = makeContext(params);
+    vector<double> replayed;
+    vector<double> fresh;
+    EXPECT_DOUBLE_EQ(tape.evaluateWithGradient(context, replayed), evaluateWithGradient(*node, context, fresh));
+    EXPECT_EQ(replayed, fresh);
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, Batch) {
+    auto node = fittingExpression();
+    GradientTape tape(*node, makeContext({1.0, 1.0, 1.0}));
+    // Rows carry an extra unused column
+    vector<double> rows{1.5, 2.0, 3.0, 9.0, 0.5, -1.0, 2.0, 9.0, -2.0, 4.0, 0.25, 9.0};
+    vector<double> values(3);
+    vector<double> gradients(9);
+    tape.evaluateWithGradient(rows, 4, values, gradients);
+    for (size_t r = 0; r < 3; ++r) {
+        SCOPED_TRACE(r);
+        auto context = makeContext({rows[r * 4], rows[r * 4 + 1], rows[r * 4 + 2]});
+        vector<double> grad;
+        EXPECT_DOUBLE_EQ(values[r], evaluateWithGradient(*node, context, grad));
+        for (size_t i = 0; i < 3; ++i) EXPECT_DOUBLE_EQ(gradients[r * 3 + i], grad[i]);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, DeepExpression) {
+    // P0 + (P1 + (P0 + ... P0)) with 10^6 additions, recorded without recursion
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (unsigned i = 1; i <= 1'000'000; ++i) node = make_unique<Add>(make_unique<Parameter>(i % 2), std::move(node));
+    vector<double> grad;
+    EXPECT_EQ(evaluateWithGradient(*node, makeContext({1.0, 2.0}), grad), 1.0 + 500'000 * 2.0 + 500'000 * 1.0);
+    ASSERT_EQ(grad.size(), 2);
+    EXPECT_EQ(grad[0], 500'001.0);
+    EXPECT_EQ(grad[1], 500'000.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestGradientTape, BatchRowTooNarrow) {
+    auto node = fittingExpression();
+    GradientTape tape(*node, makeContext({1.0, 1.0, 1.0}));
+    vector<double> rows{1.0, 2.0};
+    vector<double> values(1);
+    vector<double> gradients(3);
+    EXPECT_THROW(tape.evaluateWithGradient(rows, 2, values, gradients), out_of_range);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,139 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/IncrementalEvaluator.hpp"
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Complete tree over P0 .. P(n-1), alternating Add and Multiply per level
+unique_ptr<ASTNode> balancedTree(size_t n) {
+    vector<unique_ptr<ASTNode>> level;
+    for (size_t i = 0; i < n; ++i) level.push_back(make_unique<Parameter>(i));
+    for (bool add = true; level.size() > 1; add = !add) {
+        vector<unique_ptr<ASTNode>> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            if (add) next.push_back(make_unique<Add>(std::move(level[i]), std::move(level[i + 1])));
+            else next.push_back(make_unique<Multiply>(std::move(level[i]), std::move(level[i + 1])));
+        }
+        level = std::move(next);
+    }
+    return std::move(level.front());
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestIncrementalEvaluator, InitialValue) {
+    // (P0 + 2) * -(P1 / P0)
+    auto node = make_unique<Multiply>(make_unique<Add>(make_unique<Parameter>(0), make_unique<Constant>(2.0)),
+                                      make_unique<UnaryMinus>(make_unique<Divide>(make_unique<Parameter>(1), make_unique<Parameter>(0))));
+    vector<double> params{4.0, 8.0};
+    EvaluationContext context(params);
+    IncrementalEvaluator evaluator(*node, context);
+    EXPECT_EQ(evaluator.getNodeCount(), 8u);
+    EXPECT_EQ(evaluator.getParameterCount(), 2u);
+    EXPECT_EQ(evaluator.getValue(), -12.0);
+
+    evaluator.setParameter(1, 4.0);
+    EXPECT_EQ(evaluator.getValue(), -6.0);
+    // P1, P1 / P0, the negation and the product
+    EXPECT_EQ(evaluator.getLastRecomputed(), 4u);
+    EXPECT_DOUBLE_EQ(evaluator.getRecomputationRatio(), 0.5);
+
+    evaluator.setParameter(0, 0.0);
+    EXPECT_EQ(evaluator.getValue(), -0.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestIncrementalEvaluator, MatchesFullEvaluation) {
+    constexpr size_t numParameters = 64;
+    auto node = balancedTree(numParameters);
+    vector<double> params(numParameters, 1.0);
+    EvaluationContext context(params);
+    IncrementalEvaluator evaluator(*node, context);
+
+    mt19937 rng(42);
+    uniform_int_distribution<size_t> pick(0, numParameters - 1);
+    uniform_real_distribution<double> value(-2.0, 2.0);
+    for (int i = 0; i < 1000; ++i) {
+        size_t index = pick(rng);
+        params[index] = value(rng);
+        evaluator.setParameter(index, params[index]);
+        ASSERT_EQ(evaluator.getValue(), node->evaluate(context));
+        // At most the path from the leaf to the root
+        EXPECT_LE(evaluator.getLastRecomputed(), 7u);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestIncrementalEvaluator, RecomputationRatio) {
+    constexpr size_t numParameters = 1024;
+    auto node = balancedTree(numParameters);
+    vector<double> params(numParameters, 2.0);
+    EvaluationContext context(params);
+    IncrementalEvaluator evaluator(*node, context);
+    ASSERT_EQ(evaluator.getNodeCount(), 2 * numParameters - 1);
+
+    evaluator.setParameter(17, 3.0);
+    EXPECT_EQ(evaluator.getLastRecomputed(), 11u);
+    EXPECT_LT(evaluator.getRecomputationRatio(), 0.01);
+}
+//---------------------------------------------------------------------------
+TEST(TestIncrementalEvaluator, UnchangedValuesStopPropagation) {
+    // (P0 * 0) + P1
+    auto node = make_unique<Add>(make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Constant>(0.0)), make_unique<Parameter>(1));
+    vector<double> params{1.0, 1.0};
+    EvaluationContext context(params);
+    IncrementalEvaluator evaluator(*node, context);
+
+    evaluator.setParameter(0, 5.0);
+    EXPECT_EQ(evaluator.getValue(), 1.0);
+    EXPECT_EQ(evaluator.getLastRecomputed(), 2u);
+
+    evaluator.setParameter(1, 1.0);
+    EXPECT_EQ(evaluator.getLastRecomputed(), 1u);
+}
+//---------------------------------------------------------------------------
+TEST(TestIncrementalEvaluator, SharedParameter) {
+    // P0 * P0 - P0
+    auto node = make_unique<Subtract>(make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Parameter>(0)), make_unique<Parameter>(0));
+    vector<double> params{3.0};
+    EvaluationContext context(params);
+    IncrementalEvaluator evaluator(*node, context);
+    EXPECT_EQ(evaluator.getValue(), 6.0);
+
+    evaluator.setParameter(0, 4.0);
+    EXPECT_EQ(evaluator.getValue(), 12.0);
+    EXPECT_EQ(evaluator.getLastRecomputed(), evaluator.getNodeCount());
+}
+//---------------------------------------------------------------------------
+TEST(TestIncrementalEvaluator, DeepChain) {
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (size_t i = 0; i < 100'000; ++i) node = make_unique<Add>(std::move(node), make_unique<Constant>(1.0));
+    vector<double> params{0.0};
+    EvaluationContext context(params);
+    IncrementalEvaluator evaluator(*node, context);
+    EXPECT_EQ(evaluator.getValue(), 100'000.0);
+    evaluator.setParameter(0, 1.0);
+    EXPECT_EQ(evaluator.getValue(), 100'001.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestIncrementalEvaluator, OutOfBounds) {
+    auto node = make_unique<Add>(make_unique<Parameter>(0), make_unique<Parameter>(2));
+    vector<double> params{1.0, 2.0};
+    EvaluationContext context(params);
+    EXPECT_THROW(IncrementalEvaluator(*node, context), out_of_range);
+
+    params.push_back(3.0);
+    EvaluationContext larger(params);
+    IncrementalEvaluator evaluator(*node, larger);
+    EXPECT_EQ(evaluator.getValue(), 4.0);
+    EXPECT_THROW(evaluator.setParameter(3, 1.0), out_of_range);
+    EXPECT_THROW(evaluator.getParameter(3), out_of_range);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/IterativeTraversal.hpp"
+#include "lib/PrintVisitor.hpp"
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+constexpr size_t deepChain = 1'000'000;
+//---------------------------------------------------------------------------
+string printRecursively(ASTNode& node) {
+    stringstream stream;
+    auto* sbuf = cout.rdbuf(stream.rdbuf());
+    PrintVisitor visitor;
+    node.accept(visitor);
+    cout.rdbuf(sbuf);
+    return stream.str();
+}
+//---------------------------------------------------------------------------
+string printToString(const ASTNode& node) {
+    stringstream stream;
+    printIteratively(node, stream);
+    return stream.str();
+}
+//---------------------------------------------------------------------------
+// ((((P0 + P1) + P0) + P1) ...) with n Add nodes
+unique_ptr<ASTNode> leftDeepChain(size_t n) {
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (size_t i = 0; i < n; ++i) node = make_unique<Add>(std::move(node), make_unique<Parameter>((i + 1) % 2));
+    return node;
+}
+//---------------------------------------------------------------------------
+// Trees that exercise every rewrite rule of optimize()
+vector<function<unique_ptr<ASTNode>()>> sampleTrees() {
+    return {
+        [] { return make_unique<UnaryPlus>(make_unique<UnaryPlus>(make_unique<Add>(make_unique<Constant>(1.0), make_unique<Constant>(2.0)))); },
+        [] { return make_unique<UnaryPlus>(make_unique<Add>(make_unique<Constant>(1.0), make_unique<Constant>(2.0))); },
+        [] { return make_unique<UnaryMinus>(make_unique<Subtract>(make_unique<UnaryMinus>(make_unique<Parameter>(0)), make_unique<Parameter>(1))); },
+        [] { return make_unique<UnaryMinus>(make_unique<Subtract>(make_unique<Parameter>(0), make_unique<Parameter>(1))); },
+        [] { return make_unique<UnaryMinus>(make_unique<UnaryMinus>(make_unique<Parameter>(0))); },
+        [] { return make_unique<Add>(make_unique<Parameter>(0), make_unique<UnaryMinus>(make_unique<Parameter>(1))); },
+        [] { return make_unique<Add>(make_unique<UnaryMinus>(make_unique<Parameter>(0)), make_unique<Parameter>(1)); },
+        [] { return make_unique<Subtract>(make_unique<Constant>(0.0), make_unique<Parameter>(1)); },
+        [] { return make_unique<Multiply>(make_unique<UnaryMinus>(make_unique<Parameter>(0)), make_unique<UnaryMinus>(make_unique<Parameter>(1))); },
+        [] { return make_unique<Divide>(make_unique<Parameter>(0), make_unique<Add>(make_unique<Parameter>(1), make_unique<Constant>(0.0))); },
+        [] { return make_unique<Divide>(make_unique<Parameter>(0), make_unique<Constant>(4.0)); },
+        [] { return make_unique<Power>(make_unique<Parameter>(0), make_unique<Constant>(-1.0)); },
+        [] { return make_unique<Power>(make_unique<Multiply>(make_unique<Constant>(1.0), make_unique<Parameter>(0)), make_unique<Subtract>(make_unique<Parameter>(1), make_unique<Constant>(0.0))); },
+    };
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestIterativeTraversal, MatchesRecursiveVersions) {
+    vector<double> params{3.0, 0.5};
+    EvaluationContext context(params);
+    for (auto& make : sampleTrees()) {
+        auto recursive = make();
+        auto iterative = make();
+        SCOPED_TRACE(printRecursively(*recursive));
+        EXPECT_EQ(printToString(*iterative), printRecursively(*recursive));
+        EXPECT_EQ(evaluateIteratively(*iterative, context), recursive->evaluate(context));
+
+        recursive->optimize(recursive);
+        optimizeIteratively(iterative);
+        EXPECT_EQ(printToString(*iterative), printRecursively(*recursive));
+        EXPECT_EQ(evaluateIteratively(*iterative, context), recursive->evaluate(context));
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestIterativeTraversal, DivideByZero) {
+    vector<double> params{3.0, 0.0};
+    EvaluationContext context(params);
+    auto node = make_unique<Divide>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    EXPECT_EQ(evaluateIteratively(*node, context), 0.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestIterativeTraversal, DivideSkipsLeftInput) {
+    // Like Divide::evaluate, the divisor is computed first and the missing
+    // parameter P5 is never read when it is zero
+    vector<double> params{3.0, 0.0};
+    EvaluationContext context(params);
+    auto left = make_unique<Add>(make_unique<Parameter>(0), make_unique<Parameter>(5));
+    auto node = make_unique<Divide>(std::move(left), make_unique<Parameter>(1));
+    EXPECT_EQ(node->evaluate(context), 0.0);
+    EXPECT_EQ(evaluateIteratively(*node, context), 0.0);
+
+    params[1] = 2.0;
+    EXPECT_THROW(node->evaluate(context), out_of_range);
+    EXPECT_THROW(evaluateIteratively(*node, context), out_of_range);
+
+    // -0 divides to 0 as well
+    auto negated = make_unique<Divide>(make_unique<Parameter>(5), make_unique<UnaryMinus>(make_unique<Constant>(0.0)));
+    EXPECT_EQ(evaluateIteratively(*negated, context), negated->evaluate(context));
+}
+//---------------------------------------------------------------------------
+TEST(TestIterativeTraversal, DeepChain) {
+    auto node = leftDeepChain(deepChain);
+    vector<double> params{1.0, 2.0};
+    EvaluationContext context(params);
+    EXPECT_EQ(requiredParameterCount(*node), 2u);
+    EXPECT_EQ(evaluateIteratively(*node, context), 1.0 + 500'000 * 2.0 + 500'000 * 1.0);
+
+    string printed = printToString(*node);
+    EXPECT_EQ(printed.substr(0, 4), "((((");
+    EXPECT_EQ(printed.substr(printed.size() - 6), " + P0)");
+
+    // Destroying the chain must not recurse once per level either
+    node.reset();
+}
+//---------------------------------------------------------------------------
+TEST(TestIterativeTraversal, OptimizeDeepChain) {
+    // 0 + (0 + (0 + ... + P0)) folds down to P0
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (size_t i = 0; i < deepChain; ++i) node = make_unique<Add>(make_unique<Constant>(0.0), std::move(node));
+    optimizeIteratively(node);
+    ASSERT_EQ(node->getType(), ASTNode::Type::Parameter);
+
+    // Deep unary chains are destroyed without recursion as well
+    for (size_t i = 0; i < deepChain; ++i) node = make_unique<UnaryMinus>(std::move(node));
+    optimizeIteratively(node);
+    EXPECT_EQ(node->getType(), ASTNode::Type::Parameter);
+    for (size_t i = 0; i < deepChain; ++i) node = make_unique<UnaryPlus>(make_unique<UnaryMinus>(std::move(node)));
+}
+//---------------------------------------------------------------------------
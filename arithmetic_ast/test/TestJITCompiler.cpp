@@ -0,0 +1,149 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/IterativeTraversal.hpp"
+#include "lib/JITCompiler.hpp"
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+double interpret(ASTNode& node, const vector<double>& params) {
+    EvaluationContext context;
+    for (double p : params) context.pushParameter(p);
+    return node.evaluate(context);
+}
+//---------------------------------------------------------------------------
+unique_ptr<ASTNode> nestedExpression() {
+    // ((P0 + P1) * (P1 - P0) / 2) ^ 2
+    unique_ptr<ASTNode> node1 = make_unique<Add>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    unique_ptr<ASTNode> node2 = make_unique<Subtract>(make_unique<Parameter>(1), make_unique<Parameter>(0));
+    unique_ptr<ASTNode> node = make_unique<Multiply>(std::move(node1), std::move(node2));
+    node = make_unique<Divide>(std::move(node), make_unique<Constant>(2.0));
+    return make_unique<Power>(std::move(node), make_unique<Constant>(2.0));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, Constant) {
+    Constant c(1.5);
+    auto compiled = CompiledExpression::compile(c);
+    EXPECT_EQ(compiled.getParameterCount(), 0);
+    EXPECT_EQ(compiled.evaluate(nullptr), 1.5);
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, Parameters) {
+    auto node = make_unique<Subtract>(make_unique<Parameter>(2), make_unique<UnaryMinus>(make_unique<Parameter>(0)));
+    auto compiled = CompiledExpression::compile(*node);
+    EXPECT_EQ(compiled.getParameterCount(), 3);
+    vector<double> params{1.0, 100.0, 4.0};
+    EXPECT_EQ(compiled.evaluate(params.data()), 5.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, Nested) {
+    auto node = nestedExpression();
+    auto compiled = CompiledExpression::compile(*node);
+#if defined(__x86_64__)
+    EXPECT_TRUE(compiled.isNative());
+    ASSERT_NE(compiled.getFunction(), nullptr);
+#endif
+    vector<double> params{2.0, 4.0};
+    EXPECT_EQ(compiled.evaluate(params.data()), 36.0);
+    if (compiled.isNative()) {
+        EXPECT_EQ(compiled.getFunction()(params.data()), 36.0);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, DivideByZero) {
+    auto node = make_unique<Divide>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    auto compiled = CompiledExpression::compile(*node);
+    vector<double> params{3.0, 0.0};
+    EXPECT_EQ(compiled.evaluate(params.data()), interpret(*node, params));
+    params = {3.0, 2.0};
+    EXPECT_EQ(compiled.evaluate(params.data()), 1.5);
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, Power) {
+    for (double exponent : {-3.0, -1.0, 0.0, 1.0, 2.0, 7.0, 0.5, 2.5}) {
+        SCOPED_TRACE(exponent);
+        auto node = make_unique<Power>(make_unique<Parameter>(0), make_unique<Constant>(exponent));
+        auto compiled = CompiledExpression::compile(*node);
+        for (double base : {0.5, 1.25, 3.0}) {
+            vector<double> params{base};
+            EXPECT_DOUBLE_EQ(compiled.evaluate(params.data()), interpret(*node, params));
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, PowerCallKeepsSpilledOperands) {
+    // P0 + (P1 * (P0 ^ P1)): pow is called with one and two spilled values
+    unique_ptr<ASTNode> pow = make_unique<Power>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    unique_ptr<ASTNode> node = make_unique<Multiply>(make_unique<Parameter>(1), std::move(pow));
+    node = make_unique<Add>(make_unique<Parameter>(0), std::move(node));
+    node = make_unique<Subtract>(make_unique<Constant>(1.0), std::move(node));
+    auto compiled = CompiledExpression::compile(*node);
+    vector<double> params{1.5, 2.5};
+    EXPECT_DOUBLE_EQ(compiled.evaluate(params.data()), interpret(*node, params));
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, DeepChains) {
+    // P0 + (P1 + (P0 + ...)) spills one operand per level and is interpreted,
+    // ((P0 + P1) + P0) + ... needs no stack and stays native
+    constexpr unsigned depth = 100000;
+    unique_ptr<ASTNode> right = make_unique<Parameter>(0);
+    unique_ptr<ASTNode> left = make_unique<Parameter>(0);
+    for (unsigned i = 1; i <= depth; ++i) {
+        right = make_unique<Add>(make_unique<Parameter>(i % 2), std::move(right));
+        left = make_unique<Add>(std::move(left), make_unique<Parameter>(i % 2));
+    }
+    vector<double> params{1.0, 2.0};
+    EvaluationContext context;
+    for (double p : params) context.pushParameter(p);
+    double expected = evaluateIteratively(*right, context);
+    EXPECT_EQ(expected, 150001.0);
+
+    auto deepRight = CompiledExpression::compile(*right);
+    EXPECT_FALSE(deepRight.isNative());
+    EXPECT_EQ(deepRight.evaluate(params.data()), expected);
+    auto deepLeft = CompiledExpression::compile(*left);
+#if defined(__x86_64__)
+    EXPECT_TRUE(deepLeft.isNative());
+#endif
+    EXPECT_EQ(deepLeft.evaluate(params.data()), expected);
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, Interpreted) {
+    auto node = nestedExpression();
+    auto compiled = CompiledExpression::interpret(*node);
+    EXPECT_FALSE(compiled.isNative());
+    EXPECT_EQ(compiled.getFunction(), nullptr);
+    vector<double> params{2.0, 4.0};
+    EXPECT_EQ(compiled.evaluate(params.data()), 36.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, OptimizedTree) {
+    // a^1 + 1 * -b -> a - b
+    unique_ptr<ASTNode> node1 = make_unique<Power>(make_unique<Parameter>(0), make_unique<Constant>(1));
+    unique_ptr<ASTNode> node2 = make_unique<Multiply>(make_unique<Constant>(1), make_unique<UnaryMinus>(make_unique<Parameter>(1)));
+    unique_ptr<ASTNode> node = make_unique<Add>(std::move(node1), std::move(node2));
+    node->optimize(node);
+    auto compiled = CompiledExpression::compile(*node);
+    vector<double> params{5.0, 3.0};
+    EXPECT_EQ(compiled.evaluate(params.data()), 2.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestJITCompiler, MoveKeepsCode) {
+    auto node = nestedExpression();
+    auto compiled = CompiledExpression::compile(*node);
+    auto function = compiled.getFunction();
+    CompiledExpression moved = std::move(compiled);
+    EXPECT_EQ(moved.getFunction(), function);
+    vector<double> params{2.0, 4.0};
+    EXPECT_EQ(moved.evaluate(params.data()), 36.0);
+}
+//---------------------------------------------------------------------------
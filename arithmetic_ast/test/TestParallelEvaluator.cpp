@@ -0,0 +1,100 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/JITCompiler.hpp"
+#include "lib/ParallelEvaluator.hpp"
+#include "lib/ThreadPool.hpp"
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+unique_ptr<ASTNode> expression() {
+    // P0 * P1 - P2 / 4
+    unique_ptr<ASTNode> product = make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    return make_unique<Subtract>(std::move(product), make_unique<Divide>(make_unique<Parameter>(2), make_unique<Constant>(4.0)));
+}
+//---------------------------------------------------------------------------
+vector<double> makeRows(size_t numRows, size_t rowWidth) {
+    vector<double> rows(numRows * rowWidth);
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = static_cast<double>((i * 7919) % 101) - 50.0;
+    return rows;
+}
+//---------------------------------------------------------------------------
+vector<double> sequential(ASTNode& root, const vector<double>& rows, size_t rowWidth) {
+    vector<double> result;
+    for (size_t r = 0; r * rowWidth < rows.size(); ++r) {
+        EvaluationContext context(span<const double>(rows).subspan(r * rowWidth, rowWidth));
+        result.push_back(root.evaluate(context));
+    }
+    return result;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestParallelEvaluator, Evaluate) {
+    ThreadPool pool(4);
+    ParallelEvaluator evaluator(pool, 100);
+    auto root = expression();
+    auto rows = makeRows(10007, 3);
+    vector<double> out(10007);
+    evaluator.evaluate(*root, rows, 3, out);
+    EXPECT_EQ(out, sequential(*root, rows, 3));
+}
+//---------------------------------------------------------------------------
+TEST(TestParallelEvaluator, EvaluateCompiled) {
+    ThreadPool pool(4);
+    ParallelEvaluator evaluator(pool);
+    auto root = expression();
+    auto compiled = CompiledExpression::compile(*root);
+    // Rows may be wider than the expression needs
+    auto rows = makeRows(5000, 5);
+    vector<double> out(5000);
+    evaluator.evaluate(compiled, rows, 5, out);
+    EXPECT_EQ(out, sequential(*root, rows, 5));
+}
+//---------------------------------------------------------------------------
+TEST(TestParallelEvaluator, Reductions) {
+    ThreadPool pool(3);
+    ParallelEvaluator evaluator(pool, 64);
+    auto root = expression();
+    auto rows = makeRows(4099, 3);
+    auto expected = sequential(*root, rows, 3);
+
+    double sum = evaluator.reduce(*root, rows, 3, 4099, ParallelEvaluator::Reduction::Sum);
+    EXPECT_DOUBLE_EQ(sum, accumulate(expected.begin(), expected.end(), 0.0));
+    EXPECT_EQ(evaluator.reduce(*root, rows, 3, 4099, ParallelEvaluator::Reduction::Min), *min_element(expected.begin(), expected.end()));
+    EXPECT_EQ(evaluator.reduce(*root, rows, 3, 4099, ParallelEvaluator::Reduction::Max), *max_element(expected.begin(), expected.end()));
+
+    auto compiled = CompiledExpression::compile(*root);
+    EXPECT_EQ(evaluator.reduce(compiled, rows, 3, 4099, ParallelEvaluator::Reduction::Sum), sum);
+}
+//---------------------------------------------------------------------------
+TEST(TestParallelEvaluator, SumIsIndependentOfThreadCount) {
+    auto root = expression();
+    auto rows = makeRows(20000, 3);
+    ThreadPool small(1);
+    ThreadPool large(8);
+    ParallelEvaluator a(small, 128);
+    ParallelEvaluator b(large, 128);
+    EXPECT_EQ(a.reduce(*root, rows, 3, 20000, ParallelEvaluator::Reduction::Sum), b.reduce(*root, rows, 3, 20000, ParallelEvaluator::Reduction::Sum));
+}
+//---------------------------------------------------------------------------
+TEST(TestParallelEvaluator, RejectsNarrowRows) {
+    ThreadPool pool(2);
+    ParallelEvaluator evaluator(pool);
+    auto root = expression();
+    auto rows = makeRows(10, 2);
+    vector<double> out(10);
+    EXPECT_THROW(evaluator.evaluate(*root, rows, 2, out), out_of_range);
+    vector<double> tooMany(11);
+    EXPECT_THROW(evaluator.evaluate(*root, makeRows(10, 3), 3, tooMany), out_of_range);
+}
+//---------------------------------------------------------------------------
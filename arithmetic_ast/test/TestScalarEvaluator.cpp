@@ -0,0 +1,127 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/ScalarEvaluator.hpp"
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+using arithmetic::Complex;
+using arithmetic::Rational;
+//---------------------------------------------------------------------------
+static_assert(Scalar<float> && Scalar<double> && Scalar<Complex> && Scalar<Rational>);
+static_assert(RealPower<float> && RealPower<double>);
+static_assert(!RealPower<Complex> && !RealPower<Rational>);
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// (P0 * P0 + 1) / (P1 - 0.5) ^ 2
+unique_ptr<ASTNode> sampleTree() {
+    auto square = make_unique<Multiply>(make_unique<Parameter>(0), make_unique<Parameter>(0));
+    auto numerator = make_unique<Add>(std::move(square), make_unique<Constant>(1.0));
+    auto base = make_unique<Subtract>(make_unique<Parameter>(1), make_unique<Constant>(0.5));
+    auto denominator = make_unique<Power>(std::move(base), make_unique<Constant>(2.0));
+    return make_unique<Divide>(std::move(numerator), std::move(denominator));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestScalarEvaluator, DoubleMatchesTree) {
+    auto tree = sampleTree();
+    ScalarEvaluator<double> evaluator(*tree);
+    EXPECT_EQ(evaluator.getParameterCount(), 2u);
+    for (double p1 : {0.5, 1.5, -2.0}) {
+        vector<double> params{3.0, p1};
+        EvaluationContext context(params);
+        EXPECT_EQ(evaluator.evaluate(params), tree->evaluate(context));
+    }
+    vector<double> tooShort{1.0};
+    EXPECT_THROW(evaluator.evaluate(tooShort), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestScalarEvaluator, FloatBatch) {
+    auto tree = sampleTree();
+    ScalarEvaluator<float> evaluator(*tree);
+    constexpr size_t numRows = 1000;
+    constexpr size_t rowWidth = 3;
+    vector<float> rows(numRows * rowWidth);
+    for (size_t r = 0; r < numRows; ++r) {
+        rows[r * rowWidth] = static_cast<float>(r) * 0.25f;
+        rows[r * rowWidth + 1] = static_cast<float>(r % 7) * 0.25f;
+    }
+    vector<float> out(numRows);
+    evaluator.evaluateBatch(rows, rowWidth, out);
+    for (size_t r = 0; r < numRows; ++r) {
+        span<const float> row(rows.data() + r * rowWidth, rowWidth);
+        ASSERT_EQ(out[r], evaluator.evaluate(row)) << r;
+    }
+    // P1 == 0.5 divides by zero
+    EXPECT_EQ(out[2], 0.0f);
+
+    EXPECT_THROW(evaluator.evaluateBatch(rows, 1, out), out_of_range);
+    vector<float> tooMany(numRows + 1);
+    EXPECT_THROW(evaluator.evaluateBatch(rows, rowWidth, tooMany), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestScalarEvaluator, Complex) {
+    auto tree = sampleTree();
+    ScalarEvaluator<Complex> evaluator(*tree);
+    // P0 = i makes the numerator zero
+    vector<Complex> params{Complex(0.0, 1.0), Complex(1.5, 0.0)};
+    EXPECT_EQ(evaluator.evaluate(params), Complex(0.0, 0.0));
+
+    // (0.5 + i)^2 = -0.75 + i, 2 / (-0.75 + i) = -0.96 - 1.28i
+    params = {Complex(1.0, 0.0), Complex(1.0, 1.0)};
+    Complex result = evaluator.evaluate(params);
+    EXPECT_DOUBLE_EQ(result.real(), -0.96);
+    EXPECT_DOUBLE_EQ(result.imag(), -1.28);
+}
+//---------------------------------------------------------------------------
+TEST(TestScalarEvaluator, RationalIsExact) {
+    auto tree = sampleTree();
+    ScalarEvaluator<Rational> evaluator(*tree);
+    // (1/9 + 1) / (1/3 - 1/2)^2 = (10/9) / (1/36) = 40
+    vector<Rational> params{Rational(1, 3), Rational(1, 3)};
+    EXPECT_EQ(evaluator.evaluate(params), Rational(40));
+
+    // 1/3 is not representable as double, the Rational result is exact
+    auto third = make_unique<Add>(make_unique<Parameter>(0), make_unique<Parameter>(0));
+    ScalarEvaluator<Rational> sum(*third);
+    params = {Rational(1, 6)};
+    EXPECT_EQ(sum.evaluate(params), Rational(1, 3));
+}
+//---------------------------------------------------------------------------
+TEST(TestScalarEvaluator, IntegralPowers) {
+    // P0 ^ P1
+    auto tree = make_unique<Power>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    ScalarEvaluator<Rational> rational(*tree);
+    vector<Rational> params{Rational(2, 3), Rational(-3)};
+    EXPECT_EQ(rational.evaluate(params), Rational(27, 8));
+    params[1] = Rational(1, 2);
+    EXPECT_THROW(rational.evaluate(params), domain_error);
+
+    ScalarEvaluator<Complex> complex(*tree);
+    vector<Complex> complexParams{Complex(0.0, 1.0), Complex(4.0)};
+    EXPECT_EQ(complex.evaluate(complexParams), Complex(1.0));
+    complexParams[1] = Complex(0.5);
+    EXPECT_THROW(complex.evaluate(complexParams), domain_error);
+}
+//---------------------------------------------------------------------------
+TEST(TestScalarEvaluator, RejectsConstants) {
+    // Non-integral constant exponents are rejected up front without real powers
+    auto root = make_unique<Power>(make_unique<Parameter>(0), make_unique<Constant>(0.5));
+    EXPECT_THROW(ScalarEvaluator<Rational>{*root}, domain_error);
+    EXPECT_THROW(ScalarEvaluator<Complex>{*root}, domain_error);
+    EXPECT_NO_THROW(ScalarEvaluator<float>{*root});
+
+    // Constants are converted exactly or not at all
+    Constant tiny(1e-300);
+    EXPECT_THROW(ScalarEvaluator<Rational>{tiny}, domain_error);
+    Constant quarter(-0.25);
+    vector<Rational> none;
+    EXPECT_EQ(ScalarEvaluator<Rational>(quarter).evaluate(none), Rational(-1, 4));
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,202 @@
+#include "lib/AST.hpp"
+#include "lib/EvaluationContext.hpp"
+#include "lib/IterativeTraversal.hpp"
+#include "lib/PrintVisitor.hpp"
+#include "lib/Serialization.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+class TempFile {
+    public:
+    string path;
+
+    TempFile() : path((filesystem::temp_directory_path() / ("ast_formulas_" + to_string(getpid()) + ".bin")).string()) {}
+    ~TempFile() { remove(path.c_str()); }
+};
+//---------------------------------------------------------------------------
+string print(ASTNode& node) {
+    stringstream stream;
+    auto* sbuf = cout.rdbuf(stream.rdbuf());
+    PrintVisitor visitor;
+    node.accept(visitor);
+    cout.rdbuf(sbuf);
+    return stream.str();
+}
+//---------------------------------------------------------------------------
+vector<unique_ptr<ASTNode>> sampleFormulas() {
+    vector<unique_ptr<ASTNode>> formulas;
+    formulas.push_back(make_unique<Constant>(-0.0));
+    formulas.push_back(make_unique<Parameter>(300));
+    unique_ptr<ASTNode> node1 = make_unique<Add>(make_unique<Parameter>(0), make_unique<Parameter>(1));
+    unique_ptr<ASTNode> node2 = make_unique<Subtract>(make_unique<Parameter>(1), make_unique<UnaryPlus>(make_unique<Parameter>(0)));
+    unique_ptr<ASTNode> node = make_unique<Multiply>(std::move(node1), std::move(node2));
+    node = make_unique<Divide>(std::move(node), make_unique<Constant>(2.0));
+    formulas.push_back(make_unique<Power>(std::move(node), make_unique<Constant>(2.0)));
+    formulas.push_back(make_unique<UnaryMinus>(make_unique<Divide>(make_unique<Constant>(2.0), make_unique<Parameter>(2))));
+    return formulas;
+}
+//---------------------------------------------------------------------------
+// -(((P0 + -P1) + -P0) ...) with n Add nodes, each right input negated
+unique_ptr<ASTNode> deepFormula(size_t n) {
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (size_t i = 0; i < n; ++i) node = make_unique<Add>(std::move(node), make_unique<UnaryMinus>(make_unique<Parameter>((i + 1) % 2)));
+    return make_unique<UnaryMinus>(std::move(node));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestSerialization, RoundTrip) {
+    TempFile file;
+    auto formulas = sampleFormulas();
+    FormulaWriter writer;
+    for (auto& f : formulas) writer.add(*f);
+    EXPECT_EQ(writer.size(), formulas.size());
+    writer.write(file.path);
+
+    MappedFormulaFile mapped(file.path);
+    ASSERT_EQ(mapped.size(), formulas.size());
+    for (size_t i = 0; i < formulas.size(); ++i) {
+        SCOPED_TRACE(i);
+        auto node = mapped.materialize(i);
+        EXPECT_EQ(print(*node), print(*formulas[i]));
+        EXPECT_EQ(node->getType(), formulas[i]->getType());
+    }
+    auto& constant = static_cast<Constant&>(mapped.get(0));
+    EXPECT_TRUE(signbit(constant.getValue()));
+}
+//---------------------------------------------------------------------------
+TEST(TestSerialization, EvaluateFromMappedBytes) {
+    TempFile file;
+    auto formulas = sampleFormulas();
+    FormulaWriter writer;
+    for (auto& f : formulas) writer.add(*f);
+    writer.write(file.path);
+
+    MappedFormulaFile mapped(file.path);
+    vector<double> params(301, 0.0);
+    params[0] = 2.0;
+    params[1] = 4.0;
+    params[2] = 0.0;
+    params[300] = 7.0;
+    EvaluationContext context(params);
+    for (size_t i = 0; i < formulas.size(); ++i) {
+        SCOPED_TRACE(i);
+        EXPECT_EQ(mapped.evaluate(i, context), formulas[i]->evaluate(context));
+    }
+    EXPECT_EQ(mapped.evaluate(2, context), 36.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestSerialization, LazyMaterializationIsCached) {
+    TempFile file;
+    auto formulas = sampleFormulas();
+    FormulaWriter writer;
+    for (auto& f : formulas) writer.add(*f);
+    writer.write(file.path);
+
+    MappedFormulaFile mapped(file.path);
+    ASTNode& first = mapped.get(2);
+    EXPECT_EQ(&mapped.get(2), &first);
+    EXPECT_THROW(mapped.get(4), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestSerialization, ConstantsAreShared) {
+    TempFile file;
+    FormulaWriter writer;
+    for (int i = 0; i < 100; ++i) writer.add(Constant(2.0));
+    writer.write(file.path);
+    // header + offsets + one constant + two bytes per formula
+    EXPECT_EQ(filesystem::file_size(file.path), sizeof(FileHeader) + 101 * 8 + 8 + 200);
+}
+//---------------------------------------------------------------------------
+TEST(TestSerialization, RejectsMalformedFiles) {
+    TempFile file;
+    {
+        ofstream out(file.path, ios::binary);
+        out << "definitely not a formula file, but long enough for a header";
+    }
+    EXPECT_THROW(MappedFormulaFile mapped(file.path), runtime_error);
+    EXPECT_THROW(MappedFormulaFile mapped(file.path + ".missing"), runtime_error);
+
+    FormulaWriter writer;
+    writer.add(Add(make_unique<Parameter>(0), make_unique<Parameter>(1)));
+    writer.write(file.path);
+    // Cut off the last node byte
+    filesystem::resize_file(file.path, filesystem::file_size(file.path) - 1);
+    EXPECT_THROW(MappedFormulaFile mapped(file.path), runtime_error);
+}
+//---------------------------------------------------------------------------
+TEST(TestSerialization, ChecksParameterIndices) {
+    TempFile file;
+    FormulaWriter writer;
+    writer.add(Add(make_unique<Parameter>(0), make_unique<Parameter>(7)));
+    writer.write(file.path);
+
+    MappedFormulaFile mapped(file.path);
+    vector<double> params{1.0, 2.0};
+    EvaluationContext context(params);
+    EXPECT_THROW(mapped.evaluate(0, context), out_of_range);
+    // Validating the context for another tree must not disable the check
+    context.validate(Parameter(1));
+    EXPECT_THROW(mapped.evaluate(0, context), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestSerialization, DeepFormulas) {
+    // Deep enough to overflow the call stack if any step recursed per node
+    constexpr size_t depth = 1'000'000;
+    TempFile file;
+    auto formula = deepFormula(depth);
+    FormulaWriter writer;
+    writer.add(*formula);
+    writer.write(file.path);
+
+    MappedFormulaFile mapped(file.path);
+    vector<double> params{1.0, 2.0};
+    EvaluationContext context(params);
+    double expected = evaluateIteratively(*formula, context);
+    EXPECT_EQ(mapped.evaluate(0, context), expected);
+    auto node = mapped.materialize(0);
+    EXPECT_EQ(evaluateIteratively(*node, context), expected);
+}
+//---------------------------------------------------------------------------
+TEST(TestSerialization, RejectsDeepTruncatedFormula) {
+    // A hand-made file whose only formula is ten million UnaryMinus tags
+    // without an input at the end
+    constexpr uint64_t nodeBytes = 10'000'000;
+    TempFile file;
+    {
+        FileHeader header{};
+        memcpy(header.magic, FileHeader::expectedMagic, sizeof(header.magic));
+        header.version = FileHeader::currentVersion;
+        header.formulaCount = 1;
+        header.nodeBytes = nodeBytes;
+        uint64_t offsets[2] = {0, nodeBytes};
+        string nodes(nodeBytes, static_cast<char>(ASTNode::Type::UnaryMinus));
+        ofstream out(file.path, ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(offsets), sizeof(offsets));
+        out.write(nodes.data(), static_cast<streamsize>(nodes.size()));
+    }
+    MappedFormulaFile mapped(file.path);
+    vector<double> params{1.0};
+    EvaluationContext context(params);
+    EXPECT_THROW(mapped.evaluate(0, context), runtime_error);
+    EXPECT_THROW(mapped.materialize(0), runtime_error);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,40 @@
+#include "lib/ThreadPool.hpp"
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+TEST(TestThreadPool, Submit) {
+    ThreadPool pool(2);
+    EXPECT_EQ(pool.size(), 2);
+    promise<int> result;
+    pool.submit([&result] { result.set_value(42); });
+    EXPECT_EQ(result.get_future().get(), 42);
+}
+//---------------------------------------------------------------------------
+TEST(TestThreadPool, ParallelForVisitsEveryChunkOnce) {
+    ThreadPool pool(4);
+    vector<atomic<int>> visits(1000);
+    pool.parallelFor(visits.size(), [&visits](size_t chunk, unsigned slot) {
+        EXPECT_LT(slot, 4u);
+        ++visits[chunk];
+    });
+    for (auto& v : visits) EXPECT_EQ(v.load(), 1);
+}
+//---------------------------------------------------------------------------
+TEST(TestThreadPool, ParallelForRethrows) {
+    ThreadPool pool(3);
+    EXPECT_THROW(pool.parallelFor(100, [](size_t chunk, unsigned) {
+        if (chunk == 17) throw runtime_error("chunk failed");
+    }),
+                 runtime_error);
+    // The pool is still usable afterwards
+    atomic<size_t> count{0};
+    pool.parallelFor(10, [&count](size_t, unsigned) { ++count; });
+    EXPECT_EQ(count.load(), 10);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,109 @@
+#include "lib/AST.hpp"
+#include "lib/ThreadPool.hpp"
+#include "lib/TieredExpression.hpp"
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace ast;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// (P0 + 0) * (P1 / 2) - -P2
+unique_ptr<ASTNode> sampleTree() {
+    auto sum = make_unique<Add>(make_unique<Parameter>(0), make_unique<Constant>(0.0));
+    auto quotient = make_unique<Divide>(make_unique<Parameter>(1), make_unique<Constant>(2.0));
+    auto product = make_unique<Multiply>(std::move(sum), std::move(quotient));
+    return make_unique<Subtract>(std::move(product), make_unique<UnaryMinus>(make_unique<Parameter>(2)));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestTieredExpression, TiersUpAfterThreshold) {
+    ThreadPool pool(1);
+    TieredExpression expression(sampleTree(), pool, 10);
+    EXPECT_EQ(expression.getParameterCount(), 3u);
+    vector<double> params{3.0, 4.0, 1.0};
+
+    for (int i = 0; i < 9; ++i) EXPECT_EQ(expression.evaluate(params), 7.0);
+    EXPECT_EQ(expression.getTier(), TieredExpression::Tier::Interpreted);
+
+    EXPECT_EQ(expression.evaluate(params), 7.0);
+    expression.waitForCompilation();
+    EXPECT_EQ(expression.getTier(), TieredExpression::Tier::Compiled);
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(expression.evaluate(params), 7.0);
+
+    auto statistics = expression.getStatistics();
+    EXPECT_EQ(statistics.tier, TieredExpression::Tier::Compiled);
+    // Compiled evaluations are not counted
+    EXPECT_EQ(statistics.interpretedEvaluations, 10u);
+    EXPECT_GT(statistics.compileTime.count(), 0);
+#if defined(__x86_64__)
+    EXPECT_TRUE(statistics.native);
+#endif
+}
+//---------------------------------------------------------------------------
+TEST(TestTieredExpression, CompileImmediately) {
+    ThreadPool pool(1);
+    TieredExpression expression(sampleTree(), pool, 0);
+    expression.waitForCompilation();
+    EXPECT_EQ(expression.getStatistics().interpretedEvaluations, 0u);
+    vector<double> params{1.0, 0.0, 2.0};
+    EXPECT_EQ(expression.evaluate(params), 2.0);
+}
+//---------------------------------------------------------------------------
+TEST(TestTieredExpression, DeepExpression) {
+    // P0 - (P1 - (P0 - ...)): optimized, compiled and evaluated on the pool
+    // thread and here without recursion
+    unique_ptr<ASTNode> node = make_unique<Parameter>(0);
+    for (unsigned i = 1; i <= 100000; ++i) node = make_unique<Subtract>(make_unique<Parameter>(i % 2), std::move(node));
+    ThreadPool pool(1);
+    TieredExpression expression(std::move(node), pool, 2);
+    vector<double> params{1.0, 3.0};
+    double interpreted = expression.evaluate(params);
+    EXPECT_EQ(expression.evaluate(params), interpreted);
+    expression.waitForCompilation();
+    EXPECT_EQ(expression.getTier(), TieredExpression::Tier::Compiled);
+    EXPECT_EQ(expression.evaluate(params), interpreted);
+}
+//---------------------------------------------------------------------------
+TEST(TestTieredExpression, ColdExpressionStaysInterpreted) {
+    ThreadPool pool(1);
+    TieredExpression expression(sampleTree(), pool);
+    vector<double> params{1.0, 2.0, 3.0};
+    EXPECT_EQ(expression.evaluate(params), 4.0);
+    EXPECT_EQ(expression.getTier(), TieredExpression::Tier::Interpreted);
+    auto statistics = expression.getStatistics();
+    EXPECT_EQ(statistics.interpretedEvaluations, 1u);
+    EXPECT_FALSE(statistics.native);
+
+    vector<double> tooShort{1.0, 2.0};
+    EXPECT_THROW(expression.evaluate(tooShort), out_of_range);
+}
+//---------------------------------------------------------------------------
+TEST(TestTieredExpression, ConcurrentEvaluation) {
+    ThreadPool pool(2);
+    TieredExpression expression(sampleTree(), pool, 100);
+    vector<thread> threads;
+    vector<int> mismatches(4, 0);
+    for (unsigned t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10'000; ++i) {
+                double p = static_cast<double>(i);
+                vector<double> params{p, 2.0, p};
+                if (expression.evaluate(params) != 2.0 * p) ++mismatches[t];
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    expression.waitForCompilation();
+
+    EXPECT_EQ(mismatches, vector<int>(4, 0));
+    EXPECT_EQ(expression.getTier(), TieredExpression::Tier::Compiled);
+    EXPECT_GE(expression.getStatistics().interpretedEvaluations, 100u);
+}
+//---------------------------------------------------------------------------
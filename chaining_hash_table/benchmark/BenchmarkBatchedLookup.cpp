@@ -0,0 +1,108 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+using Table = BasicChainingHashTable<int64_t, int64_t>;
+//---------------------------------------------------------------------------
+// Keys looked up per iteration
+constexpr size_t BATCH = 4096;
+//---------------------------------------------------------------------------
+// A table with n random keys and a random sample of BATCH of them. Tables
+// with millions of entries are far larger than the last level cache.
+struct Fixture {
+    Table table;
+    vector<int64_t> keys;
+
+    explicit Fixture(size_t n) {
+        mt19937_64 rng(KEY_SEED);
+        vector<int64_t> all = uniformKeys(n, rng);
+        for (int64_t key : all) table[key] = key;
+        keys = uniformSample(all, BATCH, rng);
+    }
+};
+//---------------------------------------------------------------------------
+// Stand-in for what a hash join does with each match. It keeps the reorder
+// buffer busy, so the misses of consecutive scalar lookups no longer overlap.
+uint64_t consume(uint64_t acc, int64_t value) {
+    acc += static_cast<uint64_t>(value);
+    for (int i = 0; i < 20; ++i) acc = acc * 0x9E3779B97F4A7C15ull + (acc >> 17);
+    return acc;
+}
+//---------------------------------------------------------------------------
+void BenchmarkContains(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        for (int64_t key : fixture.keys) benchmark::DoNotOptimize(fixture.table.contains(key));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+void BenchmarkContainsMany(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    auto out = make_unique<bool[]>(BATCH);
+    for (auto _ : state) {
+        fixture.table.containsMany(fixture.keys, {out.get(), BATCH});
+        benchmark::DoNotOptimize(out.get());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+void BenchmarkFind(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        for (int64_t key : fixture.keys) benchmark::DoNotOptimize(fixture.table.find(key)->value);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+void BenchmarkFindMany(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    vector<int64_t*> out(BATCH);
+    for (auto _ : state) {
+        fixture.table.findMany(fixture.keys, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+void BenchmarkJoin(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    uint64_t acc = 0;
+    for (auto _ : state)
+        for (int64_t key : fixture.keys) acc = consume(acc, fixture.table.find(key)->value);
+    benchmark::DoNotOptimize(acc);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+void BenchmarkJoinMany(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    vector<int64_t*> out(BATCH);
+    uint64_t acc = 0;
+    for (auto _ : state) {
+        fixture.table.findMany(fixture.keys, out);
+        for (int64_t* value : out) acc = consume(acc, *value);
+    }
+    benchmark::DoNotOptimize(acc);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkContains)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(BenchmarkContainsMany)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(BenchmarkFind)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(BenchmarkFindMany)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(BenchmarkJoin)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(BenchmarkJoinMany)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,71 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Moved-from values stay valid, so the same input can be loaded repeatedly
+vector<pair<int64_t, GenericValue>> randomEntries(size_t n) {
+    mt19937_64 rng(KEY_SEED);
+    vector<pair<int64_t, GenericValue>> entries;
+    entries.reserve(n);
+    for (int64_t key : uniformKeys(n, rng)) entries.emplace_back(key, GenericValue());
+    return entries;
+}
+//---------------------------------------------------------------------------
+// Destroy the table outside the measurement
+void destroy(benchmark::State& state, unique_ptr<ChainingHashTable>& table) {
+    state.PauseTiming();
+    table.reset();
+    state.ResumeTiming();
+}
+//---------------------------------------------------------------------------
+void BenchmarkInsertLoop(benchmark::State& state) {
+    auto entries = randomEntries(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto table = make_unique<ChainingHashTable>();
+        for (auto& [key, value] : entries) table->insert(key, std::move(value));
+        destroy(state, table);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkReserveInsertLoop(benchmark::State& state) {
+    auto entries = randomEntries(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto table = make_unique<ChainingHashTable>();
+        table->reserve(entries.size());
+        for (auto& [key, value] : entries) table->insert(key, std::move(value));
+        destroy(state, table);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+void BenchmarkBulkLoad(benchmark::State& state) {
+    auto entries = randomEntries(static_cast<size_t>(state.range(0)));
+    auto threads = static_cast<unsigned>(state.range(1));
+    for (auto _ : state) {
+        auto table = make_unique<ChainingHashTable>(entries, threads);
+        destroy(state, table);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkInsertLoop)->RangeMultiplier(8)->Range(1 << 14, 1 << 23)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BenchmarkReserveInsertLoop)->RangeMultiplier(8)->Range(1 << 14, 1 << 23)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BenchmarkBulkLoad)->ArgsProduct({{1 << 14, 1 << 17, 1 << 20, 1 << 23}, {1, 2, 4, 8, 16}})->ArgNames({"n", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+#include "lib/ChainingHashTable.hpp"
+#include "lib/ConcurrentChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Keys in the table at the start; accesses go to twice as many keys, so
+// half of the lookups miss and the table stays at about this size
+constexpr int64_t KEYS = 1 << 20;
+// Operations per iteration and thread
+constexpr size_t BATCH = 1024;
+//---------------------------------------------------------------------------
+// What the shared table is replaced with: one table behind one mutex
+class LockedTable {
+    mutable mutex lock;
+    ChainingHashTable table;
+
+    public:
+    bool find(int64_t key, GenericValue& value) const {
+        lock_guard guard(lock);
+        auto it = const_cast<ChainingHashTable&>(table).find(key);
+        if (it == const_cast<ChainingHashTable&>(table).end()) return false;
+        // GenericValue cannot be copied, it is plain bytes though
+        memcpy(value.getData(), it->value.getData(), sizeof(GenericValue));
+        return true;
+    }
+    void insert(int64_t key, GenericValue&& value) {
+        lock_guard guard(lock);
+        table.insert(key, std::move(value));
+    }
+    void erase(int64_t key) {
+        lock_guard guard(lock);
+        table.erase(key);
+    }
+};
+//---------------------------------------------------------------------------
+// One table shared by all threads of all runs, filled with the even keys
+template <typename Table>
+Table& sharedTable() {
+    static Table* table = [] {
+        auto* result = new Table();
+        for (int64_t key = 0; key < 2 * KEYS; key += 2) result->insert(key, GenericValue());
+        return result;
+    }();
+    return *table;
+}
+//---------------------------------------------------------------------------
+// range(0) percent of the operations are lookups, the others insert or
+// erase with equal probability
+template <typename Table>
+void BenchmarkMixed(benchmark::State& state) {
+    Table& table = sharedTable<Table>();
+    auto readPercent = static_cast<uint64_t>(state.range(0));
+    mt19937_64 rng(static_cast<uint64_t>(state.thread_index) + 1);
+    GenericValue value;
+    for (auto _ : state) {
+        for (size_t i = 0; i < BATCH; ++i) {
+            uint64_t r = rng();
+            auto key = static_cast<int64_t>((r >> 8) % (2 * KEYS));
+            if (r % 100 < readPercent) {
+                benchmark::DoNotOptimize(table.find(key, value));
+            } else if (r & 128) {
+                table.insert(key, GenericValue());
+            } else {
+                table.erase(key);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+#define MIXED(Table) \
+    BENCHMARK_TEMPLATE(BenchmarkMixed, Table)->ArgName("readPercent")->Arg(95)->Arg(50)->ThreadRange(1, 32)->UseRealTime()
+//---------------------------------------------------------------------------
+MIXED(ConcurrentChainingHashTable);
+MIXED(LockedTable);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
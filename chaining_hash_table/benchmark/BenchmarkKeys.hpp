@@ -0,0 +1,67 @@
+#ifndef H_benchmark_BenchmarkKeys
+#define H_benchmark_BenchmarkKeys
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+//---------------------------------------------------------------------------
+// Key generators shared by the benchmarks in this directory. They all draw
+// from the generator passed in, so a benchmark seeded with KEY_SEED sees the
+// same keys in every run.
+//---------------------------------------------------------------------------
+namespace hashtable::benchmarks {
+
+constexpr uint64_t KEY_SEED = 42;
+
+// n random keys; distinct with probability ~1
+inline std::vector<int64_t> uniformKeys(size_t n, std::mt19937_64& rng) {
+    std::vector<int64_t> keys(n);
+    for (auto& key : keys) key = static_cast<int64_t>(rng());
+    return keys;
+}
+
+// The keys i << shift for i in [0, n), in ascending order
+inline std::vector<int64_t> stridedKeys(size_t n, unsigned shift) {
+    std::vector<int64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) keys[i] = static_cast<int64_t>(i << shift);
+    return keys;
+}
+
+// Draws ranks in [0, n) with P(rank) roughly proportional to 1 / (rank + 1)^s,
+// by inverting the continuous distribution. Needs no table of size n.
+class ZipfGenerator {
+    double n;
+    double s;
+
+    public:
+    ZipfGenerator(size_t n, double s) : n(static_cast<double>(n)), s(s) {}
+
+    size_t operator()(std::mt19937_64& rng) {
+        double u = std::uniform_real_distribution<double>()(rng);
+        double x = std::pow((std::pow(n + 1, 1 - s) - 1) * u + 1, 1 / (1 - s)) - 1;
+        return std::min(static_cast<size_t>(x), static_cast<size_t>(n) - 1);
+    }
+};
+
+// count keys drawn uniformly from keys
+inline std::vector<int64_t> uniformSample(const std::vector<int64_t>& keys, size_t count, std::mt19937_64& rng) {
+    std::vector<int64_t> sample(count);
+    for (auto& key : sample) key = keys[rng() % keys.size()];
+    return sample;
+}
+
+// count keys drawn from keys with a Zipfian skew of exponent s. The hot keys
+// are the first ones in keys, so random keys spread them over the key space.
+inline std::vector<int64_t> zipfSample(const std::vector<int64_t>& keys, size_t count, double s, std::mt19937_64& rng) {
+    ZipfGenerator zipf(keys.size(), s);
+    std::vector<int64_t> sample(count);
+    for (auto& key : sample) key = keys[zipf(rng)];
+    return sample;
+}
+
+} // namespace hashtable::benchmarks
+//---------------------------------------------------------------------------
+#endif
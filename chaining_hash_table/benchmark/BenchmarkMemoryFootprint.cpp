@@ -0,0 +1,91 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include "lib/Hash.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <malloc.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Bytes currently requested by all CountingAllocators
+size_t allocatedBytes = 0;
+//---------------------------------------------------------------------------
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+    T* allocate(size_t n) {
+        allocatedBytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        allocatedBytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+    bool operator==(const CountingAllocator&) const = default;
+};
+//---------------------------------------------------------------------------
+template <typename K, typename V>
+using CountedTable = BasicChainingHashTable<K, V, DefaultHash<K>, std::equal_to<K>, CountingAllocator<pair<const K, V>>>;
+template <typename K, typename V>
+using CountedUnorderedMap = unordered_map<K, V, DefaultHash<K>, std::equal_to<K>, CountingAllocator<pair<const K, V>>>;
+using GenericValueTable = CountedTable<int64_t, GenericValue>;
+using Int64Table = CountedTable<int64_t, int64_t>;
+using Int32Table = CountedTable<int64_t, int32_t>;
+using GenericValueUnorderedMap = CountedUnorderedMap<int64_t, GenericValue>;
+using Int64UnorderedMap = CountedUnorderedMap<int64_t, int64_t>;
+//---------------------------------------------------------------------------
+size_t residentBytes() {
+    ifstream statm("/proc/self/statm");
+    size_t total = 0, resident = 0;
+    statm >> total >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+//---------------------------------------------------------------------------
+// Memory held by a table of n random keys. bytes_per_entry is what the table
+// asks its allocator for; rss_per_entry also includes the malloc overhead.
+template <typename Table>
+void BenchmarkFootprint(benchmark::State& state) {
+    auto n = state.range(0);
+    mt19937_64 rng(KEY_SEED);
+    vector<int64_t> keys = uniformKeys(static_cast<size_t>(n), rng);
+    for (auto _ : state) {
+        // return the memory of earlier runs to the system
+        malloc_trim(0);
+        size_t rssBefore = residentBytes();
+        auto table = make_unique<Table>();
+        for (int64_t key : keys) (*table)[key];
+        state.counters["bytes_per_entry"] = static_cast<double>(allocatedBytes) / static_cast<double>(n);
+        state.counters["rss_per_entry"] = static_cast<double>(residentBytes() - rssBefore) / static_cast<double>(n);
+        state.PauseTiming();
+        table.reset();
+        state.ResumeTiming();
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK_TEMPLATE(BenchmarkFootprint, GenericValueTable)->Arg(10'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BenchmarkFootprint, Int64Table)->Arg(10'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BenchmarkFootprint, Int32Table)->Arg(10'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BenchmarkFootprint, GenericValueUnorderedMap)->Arg(10'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BenchmarkFootprint, Int64UnorderedMap)->Arg(10'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// glibc keeps freed list nodes in its fast bins and merges all of them on the
+// next larger allocation. After a big table was freed that takes about a
+// second, which would otherwise show up as the first rehash of the next table.
+void consolidateFreedMemory() {
+    auto block = make_unique<char[]>(1 << 12);
+    benchmark::DoNotOptimize(block.get());
+}
+//---------------------------------------------------------------------------
+// Latency of every single insert while a table grows to n entries. The table
+// passes through several resizes, so the tail percentiles show the rehash cost.
+void BenchmarkInsertLatency(benchmark::State& state) {
+    auto mode = static_cast<ChainingHashTable::RehashMode>(state.range(0));
+    auto n = static_cast<size_t>(state.range(1));
+    mt19937_64 rng(KEY_SEED);
+    vector<int64_t> keys = uniformKeys(n, rng);
+
+    vector<double> latencies;
+    latencies.reserve(n * 3);
+    consolidateFreedMemory();
+    for (auto _ : state) {
+        auto table = make_unique<ChainingHashTable>(mode);
+        for (int64_t key : keys) {
+            auto start = chrono::steady_clock::now();
+            table->insert(key, GenericValue());
+            auto stop = chrono::steady_clock::now();
+            latencies.push_back(chrono::duration<double, nano>(stop - start).count());
+        }
+        state.PauseTiming();
+        table.reset();
+        consolidateFreedMemory();
+        state.ResumeTiming();
+    }
+
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[min(latencies.size() - 1, static_cast<size_t>(p * static_cast<double>(latencies.size())))]; };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+    state.counters["max_ns"] = latencies.back();
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+//---------------------------------------------------------------------------
+void ModeArguments(benchmark::internal::Benchmark* b) {
+    for (auto mode : {ChainingHashTable::RehashMode::Blocking, ChainingHashTable::RehashMode::Incremental})
+        for (int64_t n : {1 << 16, 1 << 20, 1 << 22})
+            b->Args({static_cast<int64_t>(mode), n});
+    b->ArgNames({"incremental", "n"});
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkInsertLatency)->Apply(ModeArguments)->Iterations(3)->Unit(benchmark::kMillisecond);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/DenseHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+using Int64ChainingTable = BasicChainingHashTable<int64_t, int64_t>;
+using Int64DenseTable = BasicDenseHashTable<int64_t, int64_t>;
+//---------------------------------------------------------------------------
+template <typename Table>
+vector<int64_t> fill(Table& table, int64_t n) {
+    mt19937_64 rng(KEY_SEED);
+    vector<int64_t> keys = uniformKeys(static_cast<size_t>(n), rng);
+    for (int64_t key : keys) table[key];
+    return keys;
+}
+//---------------------------------------------------------------------------
+// Visit every entry of a table with n entries
+template <typename Table>
+void BenchmarkScan(benchmark::State& state) {
+    auto n = state.range(0);
+    Table table;
+    fill(table, n);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (auto& entry : table) sum += entry.key;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+//---------------------------------------------------------------------------
+// Same, after every second entry was erased again
+template <typename Table>
+void BenchmarkScanAfterErase(benchmark::State& state) {
+    auto n = state.range(0);
+    Table table;
+    vector<int64_t> keys = fill(table, n);
+    for (size_t i = 1; i < keys.size(); i += 2) table.erase(keys[i]);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (auto& entry : table) sum += entry.key;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(table.size()));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK_TEMPLATE(BenchmarkScan, ChainingHashTable)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BenchmarkScan, DenseHashTable)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BenchmarkScan, Int64ChainingTable)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BenchmarkScan, Int64DenseTable)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BenchmarkScanAfterErase, Int64ChainingTable)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BenchmarkScanAfterErase, Int64DenseTable)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
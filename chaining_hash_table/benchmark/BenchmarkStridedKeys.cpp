@@ -0,0 +1,62 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include "lib/Hash.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// The bucket placement of the old std::hash<int64_t> % size
+using IdentityTable = BasicChainingHashTable<int64_t, GenericValue, std::hash<int64_t>>;
+//---------------------------------------------------------------------------
+// Lookups of the keys i << shift
+template <typename Table>
+void BenchmarkStridedLookup(benchmark::State& state) {
+    auto keys = stridedKeys(static_cast<size_t>(state.range(0)), static_cast<unsigned>(state.range(1)));
+    Table table;
+    for (int64_t key : keys) table.insert(key, GenericValue());
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.contains(keys[i]));
+        if (++i == keys.size()) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+// Cost of turning a key into a bucket index
+void BenchmarkReduceModulo(benchmark::State& state) {
+    vector<int64_t> keys(4096);
+    for (size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<int64_t>(i * 7919);
+    size_t size = static_cast<size_t>(state.range(0));
+    benchmark::DoNotOptimize(size);
+    for (auto _ : state)
+        for (int64_t key : keys) benchmark::DoNotOptimize(std::hash<int64_t>{}(key) % size);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+}
+//---------------------------------------------------------------------------
+void BenchmarkReduceMixMask(benchmark::State& state) {
+    vector<int64_t> keys(4096);
+    for (size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<int64_t>(i * 7919);
+    size_t size = static_cast<size_t>(state.range(0));
+    benchmark::DoNotOptimize(size);
+    for (auto _ : state)
+        for (int64_t key : keys) benchmark::DoNotOptimize(MixHash{}(key) & (size - 1));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK_TEMPLATE(BenchmarkStridedLookup, ChainingHashTable)->ArgsProduct({{1 << 10, 1 << 13}, {0, 10, 20}})->ArgNames({"n", "shift"});
+BENCHMARK_TEMPLATE(BenchmarkStridedLookup, IdentityTable)->ArgsProduct({{1 << 10, 1 << 13}, {0, 10, 20}})->ArgNames({"n", "shift"});
+BENCHMARK(BenchmarkReduceModulo)->Arg(1 << 20);
+BENCHMARK(BenchmarkReduceMixMask)->Arg(1 << 20);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include "lib/SwissHashTable.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Random keys; the first half is inserted, the second half only used for misses
+vector<int64_t> randomKeys(size_t n) {
+    mt19937_64 rng(KEY_SEED);
+    return uniformKeys(2 * n, rng);
+}
+//---------------------------------------------------------------------------
+template <typename Table>
+void fill(Table& table, const vector<int64_t>& keys, size_t n) {
+    for (size_t i = 0; i < n; ++i) table.insert(keys[i], GenericValue());
+}
+//---------------------------------------------------------------------------
+template <typename Table>
+void BenchmarkInsert(benchmark::State& state) {
+    auto n = static_cast<size_t>(state.range(0));
+    auto keys = randomKeys(n);
+    for (auto _ : state) {
+        Table table;
+        fill(table, keys, n);
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+//---------------------------------------------------------------------------
+template <typename Table>
+void BenchmarkLookupHit(benchmark::State& state) {
+    auto n = static_cast<size_t>(state.range(0));
+    auto keys = randomKeys(n);
+    Table table;
+    fill(table, keys, n);
+    // Look the keys up in a different order than they were inserted
+    vector<int64_t> probes(keys.begin(), keys.begin() + static_cast<ptrdiff_t>(n));
+    shuffle(probes.begin(), probes.end(), mt19937_64(7));
+    size_t i = 0;
+    for (auto _ : state) {
+        auto it = table.find(probes[i]);
+        benchmark::DoNotOptimize(it->value.getData()[0]);
+        if (++i == n) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+template <typename Table>
+void BenchmarkLookupMiss(benchmark::State& state) {
+    auto n = static_cast<size_t>(state.range(0));
+    auto keys = randomKeys(n);
+    Table table;
+    fill(table, keys, n);
+    size_t i = n;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.contains(keys[i]));
+        if (++i == 2 * n) i = n;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK_TEMPLATE(BenchmarkInsert, ChainingHashTable)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BenchmarkInsert, SwissHashTable)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BenchmarkLookupHit, ChainingHashTable)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BenchmarkLookupHit, SwissHashTable)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BenchmarkLookupMiss, ChainingHashTable)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BenchmarkLookupMiss, SwissHashTable)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,190 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// The baseline every backend change is compared against
+using UnorderedMap = unordered_map<int64_t, GenericValue>;
+//---------------------------------------------------------------------------
+// Lookups and erases per iteration
+constexpr size_t BATCH = 1 << 14;
+// Generous upper bound of the memory per entry of either table plus the keys
+constexpr size_t BYTES_PER_ENTRY = 192;
+// Skew of the Zipfian accesses
+constexpr double ZIPF_EXPONENT = 0.99;
+//---------------------------------------------------------------------------
+// Key distributions. Uniform keys are random and accessed uniformly, Zipf
+// uses the same keys but accesses them with a Zipfian skew, strided keys are
+// multiples of 4096 and accessed uniformly.
+struct Uniform {};
+struct Zipf {};
+struct Strided {};
+//---------------------------------------------------------------------------
+// The keys of a table with n entries and the keys to access in it
+template <typename Distribution>
+struct Workload {
+    // The keys in the table, in insertion order
+    vector<int64_t> keys;
+    // Keys to insert, the same as keys except for Zipf, which inserts n
+    // skewed draws with many repeated keys
+    vector<int64_t> inserts;
+    // BATCH keys to look up, drawn from keys
+    vector<int64_t> hits;
+    // BATCH keys that are not in the table, following the same distribution
+    vector<int64_t> misses;
+    // Distinct keys to erase, at most BATCH
+    vector<int64_t> erases;
+
+    explicit Workload(size_t n) {
+        mt19937_64 rng(KEY_SEED);
+        if constexpr (is_same_v<Distribution, Strided>) {
+            keys = stridedKeys(n, 12);
+            shuffle(keys.begin(), keys.end(), rng);
+        } else {
+            keys = uniformKeys(n, rng);
+        }
+
+        if constexpr (is_same_v<Distribution, Zipf>) {
+            inserts = zipfSample(keys, n, ZIPF_EXPONENT, rng);
+            hits = zipfSample(keys, BATCH, ZIPF_EXPONENT, rng);
+        } else {
+            inserts = keys;
+            hits = uniformSample(keys, BATCH, rng);
+        }
+        // odd keys are not strided, and random ones collide with probability ~0
+        for (int64_t key : hits) misses.push_back(key ^ 1);
+        unordered_set<int64_t> seen;
+        for (int64_t key : hits)
+            if (seen.insert(key).second) erases.push_back(key);
+    }
+};
+//---------------------------------------------------------------------------
+int64_t keyOf(const ChainingHashTable::Entry& entry) { return entry.key; }
+int64_t keyOf(const UnorderedMap::value_type& entry) { return entry.first; }
+//---------------------------------------------------------------------------
+template <typename Table, typename Distribution>
+unique_ptr<Table> build(const Workload<Distribution>& workload) {
+    auto table = make_unique<Table>();
+    for (int64_t key : workload.keys) (*table)[key];
+    return table;
+}
+//---------------------------------------------------------------------------
+// Grow a table from empty, rehashes included
+template <typename Table, typename Distribution>
+void BenchmarkInsert(benchmark::State& state) {
+    Workload<Distribution> workload(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto table = make_unique<Table>();
+        for (int64_t key : workload.inserts) (*table)[key];
+        state.PauseTiming();
+        table.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(workload.inserts.size()));
+}
+//---------------------------------------------------------------------------
+template <typename Table, typename Distribution>
+void BenchmarkHit(benchmark::State& state) {
+    Workload<Distribution> workload(static_cast<size_t>(state.range(0)));
+    auto table = build<Table>(workload);
+    for (auto _ : state)
+        for (int64_t key : workload.hits) benchmark::DoNotOptimize(table->contains(key));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+template <typename Table, typename Distribution>
+void BenchmarkMiss(benchmark::State& state) {
+    Workload<Distribution> workload(static_cast<size_t>(state.range(0)));
+    auto table = build<Table>(workload);
+    for (auto _ : state)
+        for (int64_t key : workload.misses) benchmark::DoNotOptimize(table->contains(key));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+//---------------------------------------------------------------------------
+// Erase a batch of keys, the untimed part puts them back
+template <typename Table, typename Distribution>
+void BenchmarkErase(benchmark::State& state) {
+    Workload<Distribution> workload(static_cast<size_t>(state.range(0)));
+    auto table = build<Table>(workload);
+    for (auto _ : state) {
+        for (int64_t key : workload.erases) table->erase(key);
+        state.PauseTiming();
+        for (int64_t key : workload.erases) (*table)[key];
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(workload.erases.size()));
+}
+//---------------------------------------------------------------------------
+template <typename Table, typename Distribution>
+void BenchmarkIteration(benchmark::State& state) {
+    Workload<Distribution> workload(static_cast<size_t>(state.range(0)));
+    auto table = build<Table>(workload);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (auto& entry : *table) sum += keyOf(entry);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(table->size()));
+}
+//---------------------------------------------------------------------------
+// Grow a full table to at least twice its bucket count in one go
+template <typename Table, typename Distribution>
+void BenchmarkRehash(benchmark::State& state) {
+    Workload<Distribution> workload(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto table = build<Table>(workload);
+        state.ResumeTiming();
+        table->reserve(4 * workload.keys.size());
+        state.PauseTiming();
+        table.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(workload.keys.size()));
+}
+//---------------------------------------------------------------------------
+// 1K to 100M entries, as far as a table fits into half of the main memory
+void Sizes(benchmark::internal::Benchmark* b) {
+    auto memory = static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t n = 1'000; n <= 100'000'000; n *= 10)
+        if (n * BYTES_PER_ENTRY <= memory / 2) b->Arg(static_cast<int64_t>(n));
+    b->ArgName("n");
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+#define COMPARE(Benchmark, Distribution) \
+    BENCHMARK_TEMPLATE(Benchmark, ChainingHashTable, Distribution)->Apply(Sizes); \
+    BENCHMARK_TEMPLATE(Benchmark, UnorderedMap, Distribution)->Apply(Sizes)
+#define COMPARE_DISTRIBUTIONS(Benchmark) \
+    COMPARE(Benchmark, Uniform); \
+    COMPARE(Benchmark, Zipf); \
+    COMPARE(Benchmark, Strided)
+//---------------------------------------------------------------------------
+COMPARE_DISTRIBUTIONS(BenchmarkInsert);
+COMPARE_DISTRIBUTIONS(BenchmarkHit);
+COMPARE_DISTRIBUTIONS(BenchmarkMiss);
+COMPARE_DISTRIBUTIONS(BenchmarkErase);
+// Zipf has the same keys as Uniform and only differs in the access order
+COMPARE(BenchmarkIteration, Uniform);
+COMPARE(BenchmarkIteration, Strided);
+COMPARE(BenchmarkRehash, Uniform);
+COMPARE(BenchmarkRehash, Strided);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+#include "benchmark/BenchmarkKeys.hpp"
+#include "lib/ChainingHashTable.hpp"
+#include "lib/GenericValue.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace hashtable;
+using namespace hashtable::benchmarks;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// Keys looked up after every restart
+constexpr size_t LOOKUPS = 4096;
+//---------------------------------------------------------------------------
+// n random keys, a random sample of LOOKUPS of them, and an image of a table
+// with all keys. The image stays in the page cache, so this measures the
+// restart itself, not the disk.
+struct Fixture {
+    vector<int64_t> keys;
+    vector<int64_t> lookups;
+    string path = (filesystem::temp_directory_path() / ("chaining_ht_warm_start_" + to_string(getpid()) + ".bin")).string();
+
+    explicit Fixture(size_t n) {
+        mt19937_64 rng(KEY_SEED);
+        keys = uniformKeys(n, rng);
+        lookups = uniformSample(keys, LOOKUPS, rng);
+        ChainingHashTable table;
+        for (int64_t key : keys) table[key];
+        table.save(path);
+    }
+    ~Fixture() { remove(path.c_str()); }
+};
+//---------------------------------------------------------------------------
+void lookUp(ChainingHashTable& table, const vector<int64_t>& lookups) {
+    for (int64_t key : lookups) benchmark::DoNotOptimize(table.find(key)->value);
+}
+//---------------------------------------------------------------------------
+// Restart by inserting every entry again
+void BenchmarkRebuild(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        ChainingHashTable table;
+        for (int64_t key : fixture.keys) table[key];
+        lookUp(table, fixture.lookups);
+        state.PauseTiming();
+        table = ChainingHashTable();
+        state.ResumeTiming();
+    }
+}
+//---------------------------------------------------------------------------
+// Restart by mapping the image, the lookups fault in the pages they need
+void BenchmarkOpenMapped(benchmark::State& state) {
+    Fixture fixture(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto table = ChainingHashTable::openMapped(fixture.path);
+        lookUp(table, fixture.lookups);
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BENCHMARK(BenchmarkRebuild)->RangeMultiplier(16)->Range(1 << 15, 1 << 23)->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkOpenMapped)->RangeMultiplier(16)->Range(1 << 15, 1 << 23)->Unit(benchmark::kMillisecond);
+//---------------------------------------------------------------------------
+BENCHMARK_MAIN();
+//---------------------------------------------------------------------------
@@ -2,56 +2,269 @@
 #define H_lib_ChainingHashTable
 //---------------------------------------------------------------------------
 #include "lib/GenericValue.hpp"
+#include "lib/Hash.hpp"
+#include "lib/Instrumentation.hpp"
+#include "lib/MappedFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
 #include <vector>
-#include <list>
 #include <iterator>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <type_traits>
+#include <utility>
 //---------------------------------------------------------------------------
 
 namespace hashtable {
 //---------------------------------------------------------------------------
 
-struct HashEntry {
-    const int64_t key;
-    GenericValue value;
-    HashEntry(int64_t k, GenericValue&& v) : key(k), value(std::move(v)) {}
-    // deleted copy to emphasize const key, but default move is fine for value handled explicitly
-    HashEntry(const HashEntry&) = delete;
-    HashEntry& operator=(const HashEntry&) = delete;
+namespace detail {
+
+// Bulk loads with fewer entries per thread run on fewer threads
+constexpr size_t MIN_BULK_ENTRIES_PER_THREAD = 1 << 14;
+// Bucket ranges per thread, so that uneven ranges balance out
+constexpr size_t PARTITIONS_PER_THREAD = 8;
+
+// Run fn(t) for every t < numThreads, fn(0) on the calling thread, and
+// rethrow the first exception once all threads are done
+template <typename Fn>
+void parallelRun(unsigned numThreads, const Fn& fn) {
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto guarded = [&](unsigned t) {
+        try {
+            fn(t);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned t = 1; t < numThreads; ++t) threads.emplace_back(guarded, t);
+        guarded(0);
+    }
+    for (auto& error : errors)
+        if (error) std::rethrow_exception(error);
+}
+
+// Buckets stats() looks at for the chain length histogram at most
+constexpr size_t STATS_SAMPLE_BUCKETS = 1 << 16;
+
+// How many keys ahead findMany and containsMany prefetch, enough to keep
+// the memory system busy with independent cache misses
+constexpr size_t LOOKUP_DISTANCE = 8;
+
+inline void prefetch(const void* address) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+// A table image written by save (host byte order):
+//
+//   ImageHeader
+//   uint64_t offsets[bucketCount + 1]   first entry of every bucket
+//   Entry    entries[entryCount]        grouped by bucket, aligned for Entry
+//
+// The chain links of the entries are nullptr, a bucket is the range of
+// entries between two offsets. Nothing in the image is a pointer, so it can
+// be mapped at any address and used in place.
+struct ImageHeader {
+    static constexpr char expectedMagic[8] = {'C', 'H', 'T', 'I', 'M', 'A', 'G', 'E'};
+    static constexpr uint32_t currentVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+    uint32_t entryAlignment;
+    uint32_t keySize;
+    uint64_t bucketCount;
+    uint64_t entryCount;
 };
 
-class ChainingHashTable {
+} // namespace detail
+
+// Hash maps the keys to buckets. The bucket count is always a power of two
+// and the bucket index is the low bits of the hash. Alloc is rebound to the
+// entries and to the bucket array; it has to be default constructible.
+template <typename K, typename V, KeyHasher<K> Hash = DefaultHash<K>, typename Eq = std::equal_to<K>, typename Alloc = std::allocator<std::pair<const K, V>>>
+class BasicChainingHashTable {
 public:
-    using Entry = HashEntry;
-    using Bucket = std::list<Entry>;
-    using BucketContainer = std::vector<Bucket>;
-    using BucketIterator = typename Bucket::iterator;
-    using ConstBucketIterator = typename Bucket::const_iterator;
+    // One list node per entry. The chain link and the key come first, so a
+    // chain walk reads only the head of every node whatever sizeof(V) is,
+    // and the node has no padding beyond what V itself needs: 24 bytes for
+    // an 8 byte key and value, 80 bytes for a GenericValue.
+    class Entry {
+        Entry* next = nullptr;
+        friend class BasicChainingHashTable;
+
+    public:
+        const K key;
+        V value;
+
+        template <typename KeyArg, typename... ValueArgs>
+        explicit Entry(KeyArg&& k, ValueArgs&&... v) : key(std::forward<KeyArg>(k)), value(std::forward<ValueArgs>(v)...) {}
+        // deleted copy to emphasize const key; entries are relinked, never moved
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+    };
+
+    // The first entry of every bucket, nullptr for empty buckets
+    using BucketContainer = std::vector<Entry*, typename std::allocator_traits<Alloc>::template rebind_alloc<Entry*>>;
+
+    // Blocking moves every entry when the table grows. Incremental keeps the
+    // old buckets next to the new ones and moves a few of them on every
+    // insert and find, so that no single call pays for the whole table.
+    // Contains and erase look into both and do not move buckets. Either way
+    // entries are relinked, not copied, so references to values stay valid,
+    // and iterators stay valid across the buckets moved by find.
+    enum class RehashMode { Blocking, Incremental };
+
+    struct Statistics {
+        // Entries in the buckets and in a mapped image
+        size_t entries;
+        size_t bucketCount;
+        // Entries in the buckets per bucket
+        double loadFactor;
+        // chainLengths[k] is the number of sampled buckets with k entries
+        std::vector<size_t> chainLengths;
+        // All buckets if there are at most STATS_SAMPLE_BUCKETS, otherwise
+        // evenly spread ones
+        size_t sampledBuckets;
+        // The bucket arrays, the list nodes, and the values within the nodes.
+        // Memory that keys or values own themselves is not included.
+        size_t bucketBytes;
+        size_t nodeBytes;
+        size_t valueBytes;
+        // Entries served from a mapped image and the size of the mapping
+        size_t mappedEntries;
+        size_t mappedBytes;
+        // The counters below are only kept when built with
+        // CHAINING_HT_STATISTICS, otherwise they are zero
+        bool instrumented;
+        uint64_t rehashes;
+        // Entries compared per sampled contains or find, over recent lookups
+        double averageProbeLength;
+    };
 
 private:
+    using EntryAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+    using EntryTraits = std::allocator_traits<EntryAllocator>;
+
     // numBuckets must be declared before buckets so we can initialize buckets with it
     size_t numBuckets = 16;
     BucketContainer buckets;
     size_t numEntries = 0;
+    RehashMode rehashMode = RehashMode::Blocking;
+    // Buckets not yet migrated by an incremental rehash. Old buckets below
+    // migrateIndex are empty; the rest still hold their entries.
+    BucketContainer oldBuckets;
+    size_t migrateIndex = 0;
+    [[no_unique_address]] Hash hasher;
+    [[no_unique_address]] Eq equal;
+    [[no_unique_address]] EntryAllocator allocator;
+    // Entries served in place from a file opened by openMapped. They are
+    // never relinked into the buckets; next is nullptr for live entries and
+    // the entry itself once erased. Keys that are not in the image go to the
+    // buckets as usual.
+    struct MappedImage {
+        MappedFile file;
+        const uint64_t* offsets = nullptr;
+        Entry* entries = nullptr;
+        size_t numBuckets = 0;
+        size_t numEntries = 0;
+        size_t numLive = 0;
+    };
+    MappedImage image;
+    [[no_unique_address]] mutable detail::Instrumentation instrumentation;
     static constexpr float LOAD_FACTOR_THRESHOLD = 0.5f;
+    // Old buckets migrated per call during an incremental rehash. Migration
+    // finishes long before the new buckets reach the load factor threshold.
+    static constexpr size_t MIGRATION_BATCH = 8;
+
+    template <typename KeyArg, typename... ValueArgs>
+    Entry* createEntry(KeyArg&& key, ValueArgs&&... value);
+    void destroyEntry(Entry* entry) noexcept;
+    void destroyAll(BucketContainer& container) noexcept;
+    static Entry* link(Entry*& head, Entry* entry) noexcept;
+    template <typename ValueArg>
+    V& insertOrAssign(const K& key, ValueArg&& value);
+    Entry*& bucketFor(const K& key) noexcept;
+    Entry* const& bucketFor(const K& key) const noexcept;
+    template <typename Fn>
+    void lookupMany(std::span<const K> keys, Fn&& found) const noexcept;
+    static bool isErased(const Entry& entry) noexcept;
+    Entry* findInImage(const K& key) const noexcept;
+    template <typename Fn>
+    void forEachEntry(Fn&& fn) const;
+    static size_t imageEntriesOffset(size_t bucketCount) noexcept;
 
-    void rehash();
-    size_t hash(int64_t key, size_t size) const noexcept;
+    void rehash(size_t newSize);
+    void migrateBucket(size_t index) noexcept;
+    void migrateStep() noexcept;
+    void finishRehash() noexcept;
+    void growIfNeeded();
+    bool inOldBuckets(const K& key) const noexcept;
+    size_t hash(const K& key, size_t size) const noexcept;
+    static size_t bucketCountFor(size_t entries) noexcept;
 
 public:
-    ChainingHashTable();
-    ~ChainingHashTable();
-    ChainingHashTable(ChainingHashTable&& other) noexcept;
-    ChainingHashTable& operator=(ChainingHashTable&& other) noexcept;
+    explicit BasicChainingHashTable(RehashMode mode = RehashMode::Blocking);
+    // Bulk load. The keys and values are moved out of entries; for duplicate
+    // keys the last one wins, as with repeated insert. The buckets are
+    // allocated once and the input is partitioned by bucket range on
+    // numThreads threads (0 = one per core), so that every chain is linked by
+    // a single thread.
+    explicit BasicChainingHashTable(std::span<std::pair<K, V>> entries, unsigned numThreads = 0, RehashMode mode = RehashMode::Blocking);
+    ~BasicChainingHashTable();
+    BasicChainingHashTable(BasicChainingHashTable&& other) noexcept;
+    BasicChainingHashTable& operator=(BasicChainingHashTable&& other) noexcept;
 
     size_t size() const noexcept;
-    bool contains(int64_t key) const noexcept;
-    GenericValue& operator[](int64_t key);
-    GenericValue& insert(int64_t key, GenericValue&& value);
-    void erase(int64_t key) noexcept;
+    size_t bucketCount() const noexcept;
+    // Grow the buckets once so that n entries fit without a rehash
+    void reserve(size_t n);
+    bool contains(const K& key) const noexcept;
+    // Batched lookups. The keys are hashed and their buckets and first
+    // entries prefetched a group at a time, so that the cache misses of
+    // independent keys overlap. Like contains, they do not migrate buckets
+    // during an incremental rehash. Throw std::invalid_argument if out is
+    // shorter than keys.
+    void containsMany(std::span<const K> keys, std::span<bool> out) const;
+    // out[i] points to the value of keys[i], or is nullptr if it is missing
+    void findMany(std::span<const K> keys, std::span<V*> out);
+    V& operator[](const K& key);
+    V& insert(const K& key, V&& value);
+    V& insert(const K& key, const V& value) requires std::copyable<V>;
+    void erase(const K& key) noexcept;
+    bool isRehashing() const noexcept;
+    // Computed on demand, costs a pass over at most STATS_SAMPLE_BUCKETS
+    // buckets
+    Statistics stats() const;
+
+    // Write all entries to an image file that openMapped can use in place.
+    // Throws std::runtime_error on I/O errors.
+    void save(const std::string& path) const requires isMappable<K> && isMappable<V>;
+    // Serve the entries of an image directly from a private mapping of it,
+    // so that opening costs page faults on first access instead of a
+    // rebuild. Assigning to a mapped entry copies its page into process
+    // memory; the file is never written. New keys go to regular buckets. Hash
+    // must give the same results as in the process that saved the image.
+    // Throws std::runtime_error if the file cannot be mapped or is not an
+    // image of this table type.
+    static BasicChainingHashTable openMapped(const std::string& path, RehashMode mode = RehashMode::Blocking) requires isMappable<K> && isMappable<V>;
 
     class iterator {
     public:
@@ -62,7 +275,10 @@ public:
         using reference = Entry&;
 
         iterator() = default;
-        iterator(BucketContainer* c, size_t bi, BucketIterator it);
+        // Positioned at e in bucket bi of the current buckets of t, or at a
+        // mapped entry if bi is the bucket count. groups is the number of
+        // old buckets if t is rehashing, otherwise the bucket count.
+        iterator(BasicChainingHashTable* t, size_t groups, size_t bi, Entry* e);
 
         iterator& operator++();
         iterator operator++(int);
@@ -74,24 +290,746 @@ public:
         bool operator!=(const iterator& other) const;
 
     private:
-        BucketContainer* container = nullptr;
+        // The buckets are visited in groups: group g holds the new buckets
+        // g, g + groupCount, g + 2 * groupCount, ..., which take the entries
+        // of old bucket g. While a group is not migrated, its buckets are
+        // read from the old chain, skipping the entries of the other ones.
+        // Migration keeps the order of the old chain, so an iterator picks up
+        // where it was when find moves its group in between.
+        BasicChainingHashTable* table = nullptr;
+        size_t groupCount = 0;
         size_t bucketIndex = 0;
-        BucketIterator entryIt;
+        Entry* entry = nullptr;
+        bool is_migrated(size_t bucket) const noexcept;
+        Entry* skip_to_bucket(Entry* from, size_t bucket) const noexcept;
+        Entry* first_in_bucket(size_t bucket) const noexcept;
+        size_t next_bucket(size_t bucket) const noexcept;
         void advance_to_next_nonempty_bucket();
+        void advance_to_live_mapped_entry(Entry* from);
         bool is_end() const noexcept;
-        friend class ChainingHashTable;
+        friend class BasicChainingHashTable;
     };
 
     iterator begin();
     iterator end();
-    iterator find(int64_t key);
+    iterator find(const K& key);
 };
 
+using ChainingHashTable = BasicChainingHashTable<int64_t, GenericValue>;
+
 //---------------------------------------------------------------------------
-} // namespace hashtable
-//---------------------------------------------------------------------------
-#endif
 
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+BasicChainingHashTable<K, V, Hash, Eq, Alloc>::BasicChainingHashTable(RehashMode mode)
+    : buckets(numBuckets), numEntries(0), rehashMode(mode) {}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+BasicChainingHashTable<K, V, Hash, Eq, Alloc>::BasicChainingHashTable(std::span<std::pair<K, V>> entries, unsigned numThreads, RehashMode mode)
+    : numBuckets(bucketCountFor(entries.size())), buckets(numBuckets), numEntries(0), rehashMode(mode) {
+    size_t n = entries.size();
+    if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    numThreads = static_cast<unsigned>(std::clamp<size_t>(n / detail::MIN_BULK_ENTRIES_PER_THREAD, 1, numThreads));
 
+    // Partition p owns the buckets [p * numBuckets / numPartitions, (p + 1) * numBuckets / numPartitions)
+    size_t numPartitions = std::min(numBuckets, numThreads * detail::PARTITIONS_PER_THREAD);
+    auto partitionOf = [&](const K& key) { return hash(key, numBuckets) * numPartitions / numBuckets; };
+    auto chunkBegin = [&](unsigned t) { return n * t / numThreads; };
+
+    // Count the entries of every input chunk per partition
+    std::vector<size_t> offsets(numThreads * numPartitions);
+    detail::parallelRun(numThreads, [&](unsigned t) {
+        size_t* counts = offsets.data() + t * numPartitions;
+        for (size_t i = chunkBegin(t); i < chunkBegin(t + 1); ++i) ++counts[partitionOf(entries[i].first)];
+    });
+
+    // Partition-major prefix sum: the chunks of a partition stay in input order
+    std::vector<size_t> partitionBegin(numPartitions + 1);
+    size_t sum = 0;
+    for (size_t p = 0; p < numPartitions; ++p) {
+        partitionBegin[p] = sum;
+        for (unsigned t = 0; t < numThreads; ++t) {
+            size_t count = offsets[t * numPartitions + p];
+            offsets[t * numPartitions + p] = sum;
+            sum += count;
+        }
+    }
+    partitionBegin[numPartitions] = sum;
+
+    // Scatter the entry indices into their partitions
+    std::vector<size_t> order(n);
+    detail::parallelRun(numThreads, [&](unsigned t) {
+        size_t* next = offsets.data() + t * numPartitions;
+        for (size_t i = chunkBegin(t); i < chunkBegin(t + 1); ++i) order[next[partitionOf(entries[i].first)]++] = i;
+    });
+
+    // Link the chains, no two threads ever touch the same bucket
+    std::atomic<size_t> nextPartition{0};
+    std::vector<size_t> inserted(numThreads);
+    try {
+        detail::parallelRun(numThreads, [&](unsigned t) {
+            for (size_t p; (p = nextPartition.fetch_add(1, std::memory_order_relaxed)) < numPartitions;) {
+                for (size_t k = partitionBegin[p]; k < partitionBegin[p + 1]; ++k) {
+                    auto& [key, value] = entries[order[k]];
+                    Entry*& head = buckets[hash(key, numBuckets)];
+                    Entry* entry = head;
+                    while (entry && !equal(entry->key, key)) entry = entry->next;
+                    if (entry) {
+                        entry->value = std::move(value);
+                    } else {
+                        link(head, createEntry(std::move(key), std::move(value)));
+                        ++inserted[t];
+                    }
+                }
+            }
+        });
+    } catch (...) {
+        // the destructor does not run for a constructor that throws
+        destroyAll(buckets);
+        throw;
+    }
+    for (size_t count : inserted) numEntries += count;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+BasicChainingHashTable<K, V, Hash, Eq, Alloc>::BasicChainingHashTable(BasicChainingHashTable&& other) noexcept
+    : numBuckets(other.numBuckets),
+      buckets(std::move(other.buckets)),
+      numEntries(other.numEntries),
+      rehashMode(other.rehashMode),
+      oldBuckets(std::move(other.oldBuckets)),
+      migrateIndex(other.migrateIndex),
+      hasher(other.hasher),
+      equal(other.equal),
+      allocator(std::move(other.allocator)),
+      image(std::move(other.image)),
+      instrumentation(other.instrumentation) {
+    other.image = MappedImage();
+    other.instrumentation = detail::Instrumentation();
+    other.buckets.clear();
+    other.oldBuckets.clear();
+    other.numEntries = 0;
+    other.numBuckets = 0;
+    other.migrateIndex = 0;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+BasicChainingHashTable<K, V, Hash, Eq, Alloc>::~BasicChainingHashTable() {
+    destroyAll(buckets);
+    destroyAll(oldBuckets);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+BasicChainingHashTable<K, V, Hash, Eq, Alloc>& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::operator=(BasicChainingHashTable&& other) noexcept {
+    if (this != &other) {
+        destroyAll(buckets);
+        destroyAll(oldBuckets);
+        numBuckets = other.numBuckets;
+        buckets = std::move(other.buckets);
+        numEntries = other.numEntries;
+        rehashMode = other.rehashMode;
+        oldBuckets = std::move(other.oldBuckets);
+        migrateIndex = other.migrateIndex;
+        hasher = other.hasher;
+        equal = other.equal;
+        allocator = std::move(other.allocator);
+        image = std::move(other.image);
+        instrumentation = other.instrumentation;
+        other.image = MappedImage();
+        other.instrumentation = detail::Instrumentation();
+        other.buckets.clear();
+        other.oldBuckets.clear();
+        other.numEntries = 0;
+        other.numBuckets = 0;
+        other.migrateIndex = 0;
+    }
+    return *this;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+template <typename KeyArg, typename... ValueArgs>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Entry* BasicChainingHashTable<K, V, Hash, Eq, Alloc>::createEntry(KeyArg&& key, ValueArgs&&... value) {
+    Entry* entry = EntryTraits::allocate(allocator, 1);
+    try {
+        EntryTraits::construct(allocator, entry, std::forward<KeyArg>(key), std::forward<ValueArgs>(value)...);
+    } catch (...) {
+        EntryTraits::deallocate(allocator, entry, 1);
+        throw;
+    }
+    return entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::destroyEntry(Entry* entry) noexcept {
+    EntryTraits::destroy(allocator, entry);
+    EntryTraits::deallocate(allocator, entry, 1);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::destroyAll(BucketContainer& container) noexcept {
+    // iterative, long chains must not exhaust the stack
+    for (Entry*& head : container) {
+        while (head) {
+            Entry* next = head->next;
+            destroyEntry(head);
+            head = next;
+        }
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Entry* BasicChainingHashTable<K, V, Hash, Eq, Alloc>::link(Entry*& head, Entry* entry) noexcept {
+    entry->next = head;
+    head = entry;
+    return entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+size_t BasicChainingHashTable<K, V, Hash, Eq, Alloc>::hash(const K& key, size_t size) const noexcept {
+    // size is a power of two
+    return static_cast<size_t>(hasher(key)) & (size - 1);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+size_t BasicChainingHashTable<K, V, Hash, Eq, Alloc>::bucketCountFor(size_t entries) noexcept {
+    size_t count = 16;
+    while (static_cast<float>(entries) > static_cast<float>(count) * LOAD_FACTOR_THRESHOLD) count *= 2;
+    return count;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::rehash(size_t newSize) {
+    BucketContainer newBuckets(newSize);
+    oldBuckets = std::move(buckets);
+    buckets = std::move(newBuckets);
+    numBuckets = newSize;
+    migrateIndex = 0;
+    instrumentation.countRehash();
+
+    if (rehashMode == RehashMode::Blocking) finishRehash();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::migrateBucket(size_t index) noexcept {
+    // Reverse the chain first, so that pushing to the front keeps the old
+    // order within every new bucket; iterators rely on it
+    Entry* reversed = nullptr;
+    for (Entry* entry = oldBuckets[index]; entry;) {
+        Entry* next = entry->next;
+        entry->next = reversed;
+        reversed = entry;
+        entry = next;
+    }
+    oldBuckets[index] = nullptr;
+    while (reversed) {
+        Entry* next = reversed->next;
+        // relink the node, nothing is allocated or copied
+        link(buckets[hash(reversed->key, numBuckets)], reversed);
+        reversed = next;
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::migrateStep() noexcept {
+    if (oldBuckets.empty()) return;
+    size_t end = std::min(oldBuckets.size(), migrateIndex + MIGRATION_BATCH);
+    for (; migrateIndex < end; ++migrateIndex) migrateBucket(migrateIndex);
+    if (migrateIndex == oldBuckets.size()) {
+        oldBuckets = BucketContainer();
+        migrateIndex = 0;
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::finishRehash() noexcept {
+    while (!oldBuckets.empty()) migrateStep();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::growIfNeeded() {
+    migrateStep();
+    if (static_cast<float>(numEntries + 1) > static_cast<float>(numBuckets) * LOAD_FACTOR_THRESHOLD) {
+        // a previous incremental rehash must be complete before the next one starts
+        finishRehash();
+        rehash(std::max<size_t>(1, numBuckets * 2));
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::inOldBuckets(const K& key) const noexcept {
+    return !oldBuckets.empty() && hash(key, oldBuckets.size()) >= migrateIndex;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Entry*& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::bucketFor(const K& key) noexcept {
+    auto& container = inOldBuckets(key) ? oldBuckets : buckets;
+    return container[hash(key, container.size())];
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Entry* const& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::bucketFor(const K& key) const noexcept {
+    const auto& container = inOldBuckets(key) ? oldBuckets : buckets;
+    return container[hash(key, container.size())];
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::isRehashing() const noexcept {
+    return !oldBuckets.empty();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Statistics BasicChainingHashTable<K, V, Hash, Eq, Alloc>::stats() const {
+    Statistics result{};
+    result.entries = size();
+    result.bucketCount = numBuckets;
+    result.loadFactor = numBuckets ? static_cast<double>(numEntries) / static_cast<double>(numBuckets) : 0.0;
+
+    // old buckets below migrateIndex are empty and not sampled
+    size_t total = buckets.size() + oldBuckets.size() - migrateIndex;
+    size_t stride = std::max<size_t>(1, (total + detail::STATS_SAMPLE_BUCKETS - 1) / detail::STATS_SAMPLE_BUCKETS);
+    auto sample = [&](const BucketContainer& container, size_t begin) {
+        for (size_t i = begin; i < container.size(); i += stride) {
+            size_t length = 0;
+            for (const Entry* entry = container[i]; entry; entry = entry->next) ++length;
+            if (length >= result.chainLengths.size()) result.chainLengths.resize(length + 1);
+            ++result.chainLengths[length];
+            ++result.sampledBuckets;
+        }
+    };
+    sample(oldBuckets, migrateIndex);
+    sample(buckets, 0);
 
+    result.bucketBytes = (buckets.capacity() + oldBuckets.capacity()) * sizeof(Entry*);
+    result.nodeBytes = numEntries * sizeof(Entry);
+    result.valueBytes = numEntries * sizeof(V);
+    result.mappedEntries = image.numLive;
+    result.mappedBytes = image.file.size();
+    result.instrumented = detail::Instrumentation::enabled;
+    result.rehashes = instrumentation.getRehashes();
+    result.averageProbeLength = instrumentation.getAverageProbeLength();
+    return result;
+}
 
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+size_t BasicChainingHashTable<K, V, Hash, Eq, Alloc>::size() const noexcept {
+    return numEntries + image.numLive;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+size_t BasicChainingHashTable<K, V, Hash, Eq, Alloc>::bucketCount() const noexcept {
+    return numBuckets;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::reserve(size_t n) {
+    finishRehash();
+    size_t newSize = bucketCountFor(n);
+    if (newSize <= numBuckets) return;
+    rehash(newSize);
+    finishRehash();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::contains(const K& key) const noexcept {
+    if (buckets.empty()) return false;
+    size_t probes = 0;
+    for (const Entry* entry = bucketFor(key); entry; entry = entry->next) {
+        ++probes;
+        if (equal(entry->key, key)) {
+            instrumentation.countLookup(probes);
+            return true;
+        }
+    }
+    instrumentation.countLookup(probes);
+    return findInImage(key) != nullptr;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::isErased(const Entry& entry) noexcept {
+    // only used for mapped entries, chained entries are never erased in place
+    return entry.next == &entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Entry* BasicChainingHashTable<K, V, Hash, Eq, Alloc>::findInImage(const K& key) const noexcept {
+    if (image.numBuckets == 0) return nullptr;
+    size_t index = hash(key, image.numBuckets);
+    // clamped, so a corrupt image cannot make us read past the mapping
+    uint64_t end = std::min<uint64_t>(image.offsets[index + 1], image.numEntries);
+    for (uint64_t i = image.offsets[index]; i < end; ++i) {
+        Entry* entry = image.entries + i;
+        if (!isErased(*entry) && equal(entry->key, key)) return entry;
+    }
+    return nullptr;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+template <typename Fn>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::lookupMany(std::span<const K> keys, Fn&& found) const noexcept {
+    // Three stages, LOOKUP_DISTANCE keys apart: resolve a key, prefetch the
+    // first entry of a later bucket, and hash a key further ahead and
+    // prefetch its bucket. By the time a key is resolved, its bucket and
+    // first entry should be in the cache. Keys that are not in the buckets
+    // are looked up in a mapped image, which goes through the same stages.
+    constexpr size_t distance = detail::LOOKUP_DISTANCE;
+    constexpr size_t ringSize = 2 * distance;
+    Entry* const* heads[ringSize];
+    size_t imageBuckets[ringSize];
+    size_t n = keys.size();
+    bool rehashing = isRehashing();
+    bool mapped = image.numBuckets != 0;
+    for (size_t i = 0; i < n + 2 * distance; ++i) {
+        // the slot of key i - 2 * distance is reused for key i below
+        if (i >= 2 * distance) {
+            size_t j = i - 2 * distance;
+            Entry* entry = *heads[j % ringSize];
+            while (entry && !equal(entry->key, keys[j])) entry = entry->next;
+            if (!entry && mapped) entry = findInImage(keys[j]);
+            found(j, entry);
+        }
+        if (i >= distance && i - distance < n) {
+            size_t slot = (i - distance) % ringSize;
+            if (Entry* first = *heads[slot]) detail::prefetch(first);
+            if (mapped) detail::prefetch(image.entries + image.offsets[imageBuckets[slot]]);
+        }
+        if (i < n) {
+            Entry* const* head = rehashing ? &bucketFor(keys[i]) : &buckets[hash(keys[i], numBuckets)];
+            heads[i % ringSize] = head;
+            detail::prefetch(head);
+            if (mapped) {
+                imageBuckets[i % ringSize] = hash(keys[i], image.numBuckets);
+                detail::prefetch(image.offsets + imageBuckets[i % ringSize]);
+            }
+        }
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::containsMany(std::span<const K> keys, std::span<bool> out) const {
+    if (out.size() < keys.size()) throw std::invalid_argument("containsMany: out is shorter than keys");
+    if (buckets.empty()) {
+        std::fill_n(out.begin(), keys.size(), false);
+        return;
+    }
+    lookupMany(keys, [&](size_t i, const Entry* entry) { out[i] = entry != nullptr; });
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::findMany(std::span<const K> keys, std::span<V*> out) {
+    if (out.size() < keys.size()) throw std::invalid_argument("findMany: out is shorter than keys");
+    if (buckets.empty()) {
+        std::fill_n(out.begin(), keys.size(), nullptr);
+        return;
+    }
+    lookupMany(keys, [&](size_t i, Entry* entry) { out[i] = entry ? &entry->value : nullptr; });
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+V& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::operator[](const K& key) {
+    if (buckets.empty()) buckets.resize(numBuckets);
+    if (Entry* entry = findInImage(key)) return entry->value;
+
+    // grow before inserting so that the load factor holds afterwards
+    growIfNeeded();
+
+    Entry*& head = bucketFor(key);
+    for (Entry* entry = head; entry; entry = entry->next) {
+        if (equal(entry->key, key)) return entry->value;
+    }
+
+    Entry* entry = link(head, createEntry(key));
+    ++numEntries;
+    return entry->value;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+template <typename ValueArg>
+V& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::insertOrAssign(const K& key, ValueArg&& value) {
+    if (buckets.empty()) buckets.resize(numBuckets);
+    if (Entry* entry = findInImage(key)) {
+        entry->value = std::forward<ValueArg>(value);
+        return entry->value;
+    }
+
+    // ensure capacity before inserting
+    growIfNeeded();
+
+    Entry*& head = bucketFor(key);
+    for (Entry* entry = head; entry; entry = entry->next) {
+        if (equal(entry->key, key)) {
+            entry->value = std::forward<ValueArg>(value);
+            return entry->value;
+        }
+    }
+
+    Entry* entry = link(head, createEntry(key, std::forward<ValueArg>(value)));
+    ++numEntries;
+    return entry->value;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+V& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::insert(const K& key, V&& value) {
+    return insertOrAssign(key, std::move(value));
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+V& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::insert(const K& key, const V& value) requires std::copyable<V> {
+    return insertOrAssign(key, value);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::erase(const K& key) noexcept {
+    if (buckets.empty()) return;
+    for (Entry** next = &bucketFor(key); *next; next = &(*next)->next) {
+        Entry* entry = *next;
+        if (equal(entry->key, key)) {
+            *next = entry->next;
+            destroyEntry(entry);
+            --numEntries;
+            return;
+        }
+    }
+    if (Entry* entry = findInImage(key)) {
+        // mapped entries own nothing, marking them is enough
+        entry->next = entry;
+        --image.numLive;
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+template <typename Fn>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::forEachEntry(Fn&& fn) const {
+    // old buckets below migrateIndex are empty
+    for (const BucketContainer* container : {&oldBuckets, &buckets}) {
+        for (const Entry* head : *container) {
+            for (const Entry* entry = head; entry; entry = entry->next) fn(*entry);
+        }
+    }
+    for (size_t i = 0; i < image.numEntries; ++i) {
+        if (!isErased(image.entries[i])) fn(image.entries[i]);
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+size_t BasicChainingHashTable<K, V, Hash, Eq, Alloc>::imageEntriesOffset(size_t bucketCount) noexcept {
+    size_t offsetsEnd = sizeof(detail::ImageHeader) + (bucketCount + 1) * sizeof(uint64_t);
+    return (offsetsEnd + alignof(Entry) - 1) / alignof(Entry) * alignof(Entry);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::save(const std::string& path) const requires isMappable<K> && isMappable<V> {
+    size_t count = size();
+    size_t fileBuckets = bucketCountFor(count);
+
+    // Group the entries by bucket with a counting sort of pointers to them
+    std::vector<uint64_t> offsets(fileBuckets + 1);
+    forEachEntry([&](const Entry& entry) { ++offsets[hash(entry.key, fileBuckets) + 1]; });
+    for (size_t i = 0; i < fileBuckets; ++i) offsets[i + 1] += offsets[i];
+    std::vector<const Entry*> order(count);
+    {
+        std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+        forEachEntry([&](const Entry& entry) { order[next[hash(entry.key, fileBuckets)]++] = &entry; });
+    }
+
+    detail::ImageHeader header{};
+    std::memcpy(header.magic, detail::ImageHeader::expectedMagic, sizeof(header.magic));
+    header.version = detail::ImageHeader::currentVersion;
+    header.entrySize = sizeof(Entry);
+    header.entryAlignment = alignof(Entry);
+    header.keySize = sizeof(K);
+    header.bucketCount = fileBuckets;
+    header.entryCount = count;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+    size_t padding = imageEntriesOffset(fileBuckets) - sizeof(header) - offsets.size() * sizeof(uint64_t);
+    const char zeros[alignof(Entry)] = {};
+    out.write(zeros, static_cast<std::streamsize>(padding));
+    alignas(Entry) std::byte record[sizeof(Entry)];
+    for (const Entry* entry : order) {
+        std::memcpy(record, static_cast<const void*>(entry), sizeof(Entry));
+        // a chain link means nothing in another process
+        reinterpret_cast<Entry*>(record)->next = nullptr;
+        out.write(reinterpret_cast<const char*>(record), sizeof(Entry));
+    }
+    if (!out) throw std::runtime_error("Cannot write " + path);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+BasicChainingHashTable<K, V, Hash, Eq, Alloc> BasicChainingHashTable<K, V, Hash, Eq, Alloc>::openMapped(const std::string& path, RehashMode mode) requires isMappable<K> && isMappable<V> {
+    MappedFile file(path);
+    // Only the header and the last offset are checked, so opening does not
+    // touch the entries
+    const auto* header = reinterpret_cast<const detail::ImageHeader*>(file.data());
+    size_t available = file.size() - std::min(file.size(), sizeof(detail::ImageHeader));
+    bool valid = file.size() >= sizeof(detail::ImageHeader)
+        && std::memcmp(header->magic, detail::ImageHeader::expectedMagic, sizeof(header->magic)) == 0
+        && header->version == detail::ImageHeader::currentVersion
+        && header->entrySize == sizeof(Entry)
+        && header->entryAlignment == alignof(Entry)
+        && header->keySize == sizeof(K)
+        && std::has_single_bit(header->bucketCount)
+        && header->bucketCount < available / sizeof(uint64_t);
+    if (valid) {
+        size_t entriesOffset = imageEntriesOffset(header->bucketCount);
+        const auto* offsets = reinterpret_cast<const uint64_t*>(file.data() + sizeof(detail::ImageHeader));
+        valid = entriesOffset <= file.size()
+            && header->entryCount == (file.size() - entriesOffset) / sizeof(Entry)
+            && (file.size() - entriesOffset) % sizeof(Entry) == 0
+            && offsets[header->bucketCount] == header->entryCount;
+        if (valid) {
+            BasicChainingHashTable table(mode);
+            auto* entries = reinterpret_cast<Entry*>(file.data() + entriesOffset);
+            size_t bucketCount = header->bucketCount;
+            size_t entryCount = header->entryCount;
+            table.image = MappedImage{std::move(file), offsets, entries, bucketCount, entryCount, entryCount};
+            return table;
+        }
+    }
+    throw std::runtime_error("Not a hash table image: " + path);
+}
+
+//--------------------------iterator------------------------------------
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::iterator(BasicChainingHashTable* t, size_t groups, size_t bi, Entry* e)
+    : table(t), groupCount(groups), bucketIndex(bi), entry(e) {}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::is_end() const noexcept {
+    return table == nullptr || (bucketIndex >= table->buckets.size() && entry == nullptr);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::is_migrated(size_t bucket) const noexcept {
+    return !table->isRehashing() || (bucket & (groupCount - 1)) < table->migrateIndex;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Entry* BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::skip_to_bucket(Entry* from, size_t bucket) const noexcept {
+    while (from && table->hash(from->key, table->numBuckets) != bucket) from = from->next;
+    return from;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::Entry* BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::first_in_bucket(size_t bucket) const noexcept {
+    if (is_migrated(bucket)) return table->buckets[bucket];
+    return skip_to_bucket(table->oldBuckets[bucket & (groupCount - 1)], bucket);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+size_t BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::next_bucket(size_t bucket) const noexcept {
+    if (bucket + groupCount < table->buckets.size()) return bucket + groupCount;
+    size_t group = (bucket & (groupCount - 1)) + 1;
+    return group < groupCount ? group : table->buckets.size();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::advance_to_next_nonempty_bucket() {
+    if (!table) return;
+    for (; bucketIndex < table->buckets.size(); bucketIndex = next_bucket(bucketIndex)) {
+        entry = first_in_bucket(bucketIndex);
+        if (entry) return;
+    }
+    // the mapped entries come after the last bucket
+    advance_to_live_mapped_entry(table->image.entries);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+void BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::advance_to_live_mapped_entry(Entry* from) {
+    Entry* last = table->image.entries + table->image.numEntries;
+    while (from != last && isErased(*from)) ++from;
+    entry = from != last ? from : nullptr;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator BasicChainingHashTable<K, V, Hash, Eq, Alloc>::begin() {
+    if (buckets.empty()) return end();
+    iterator it(this, isRehashing() ? oldBuckets.size() : buckets.size(), 0, nullptr);
+    it.advance_to_next_nonempty_bucket();
+    return it;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator BasicChainingHashTable<K, V, Hash, Eq, Alloc>::end() {
+    return iterator(this, buckets.size(), buckets.size(), nullptr);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator BasicChainingHashTable<K, V, Hash, Eq, Alloc>::find(const K& key) {
+    if (buckets.empty()) return end();
+    migrateStep();
+    size_t groups = isRehashing() ? oldBuckets.size() : buckets.size();
+    const auto& container = inOldBuckets(key) ? oldBuckets : buckets;
+    size_t probes = 0;
+    for (Entry* entry = container[hash(key, container.size())]; entry; entry = entry->next) {
+        ++probes;
+        if (equal(entry->key, key)) {
+            instrumentation.countLookup(probes);
+            return iterator(this, groups, hash(key, numBuckets), entry);
+        }
+    }
+    instrumentation.countLookup(probes);
+    // iterating on from a mapped entry reaches the rest of the image
+    if (Entry* entry = findInImage(key)) return iterator(this, groups, buckets.size(), entry);
+    return end();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator& BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::operator++() {
+    if (!table) return *this;
+    if (bucketIndex >= table->buckets.size()) {
+        // past the buckets, either in the mapped entries or already end
+        if (entry) advance_to_live_mapped_entry(entry + 1);
+        return *this;
+    }
+
+    entry = is_migrated(bucketIndex) ? entry->next : skip_to_bucket(entry->next, bucketIndex);
+    if (entry) {
+        return *this;
+    }
+
+    // move to next non-empty bucket
+    bucketIndex = next_bucket(bucketIndex);
+    advance_to_next_nonempty_bucket();
+    return *this;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::operator++(int) {
+    iterator tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::reference BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::operator*() const {
+    return *entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+typename BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::pointer BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::operator->() const {
+    return entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::operator==(const iterator& other) const {
+    if (table != other.table) return false;
+    if (is_end() && other.is_end()) return true;
+    if (bucketIndex != other.bucketIndex) return false;
+    return entry == other.entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq, typename Alloc>
+bool BasicChainingHashTable<K, V, Hash, Eq, Alloc>::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
+
+// Instantiated once in ChainingHashTable.cpp
+extern template class BasicChainingHashTable<int64_t, GenericValue>;
+
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,10 @@
+#include "lib/ConcurrentChainingHashTable.hpp"
+//---------------------------------------------------------------------------
+namespace hashtable {
+//---------------------------------------------------------------------------
+
+template class BasicConcurrentChainingHashTable<int64_t, GenericValue>;
+
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
@@ -0,0 +1,376 @@
+#ifndef H_lib_ConcurrentChainingHashTable
+#define H_lib_ConcurrentChainingHashTable
+//---------------------------------------------------------------------------
+#include "lib/GenericValue.hpp"
+#include "lib/Hash.hpp"
+#include "lib/MappedFile.hpp"
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+//---------------------------------------------------------------------------
+
+namespace hashtable {
+//---------------------------------------------------------------------------
+
+// Chaining hash table for many threads. The high bits of the hash pick one
+// of a fixed number of shards; every shard is a chaining table of its own,
+// with its own lock, bucket array and growth. Writers lock their shard.
+// Readers take no lock: they walk the chain optimistically and check the
+// sequence number of the shard, which writers keep odd while they change
+// the shard, and retry if it moved (a seqlock). A reader only waits while a
+// writer is inside the same shard.
+//
+// Readers may look at a node while it is relinked, reused or assigned to,
+// so nothing is ever freed while the table lives: erased nodes are kept by
+// their shard for the next insert, and bucket arrays replaced by growth are
+// kept until destruction (together they are smaller than the current one).
+// Keys and values are stored as words with relaxed atomic loads and stores,
+// so K and V have to be plain bytes, and values are returned by copy. A
+// reader copies each key out before comparing it, and the copy may be torn
+// between two writes: Eq must give some answer for any bytes of K, which the
+// check of the sequence number then throws away. Hash must mix into the high
+// bits, as DefaultHash does, or everything ends up in one shard.
+namespace detail {
+// The bytes of a T as words that readers load and writers store with relaxed
+// atomics, as in the usual seqlock: a reader may copy bytes of two different
+// writes, which it detects by the sequence number, but it never races on
+// plain memory
+template <typename T>
+class AtomicBytes {
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    std::atomic<uint64_t> words[WORDS] = {};
+
+public:
+    void store(const T& value) noexcept {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, static_cast<const void*>(&value), sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    void load(T& value) const noexcept {
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) buffer[i] = words[i].load(std::memory_order_relaxed);
+        std::memcpy(static_cast<void*>(&value), buffer, sizeof(T));
+    }
+};
+} // namespace detail
+
+template <typename K, typename V, KeyHasher<K> Hash = DefaultHash<K>, typename Eq = std::equal_to<K>>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+class BasicConcurrentChainingHashTable {
+    struct Node {
+        std::atomic<Node*> next = nullptr;
+        detail::AtomicBytes<K> key;
+        detail::AtomicBytes<V> value;
+    };
+
+    struct BucketArray {
+        const size_t size;
+        const std::unique_ptr<std::atomic<Node*>[]> heads;
+
+        explicit BucketArray(size_t size) : size(size), heads(std::make_unique<std::atomic<Node*>[]>(size)) {}
+    };
+
+    // A cache line each, so that writers in one shard do not slow down
+    // readers of the next
+    struct alignas(64) Shard {
+        std::mutex lock;
+        // Odd while a writer changes the shard
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<BucketArray*> buckets{nullptr};
+        std::atomic<size_t> numEntries{0};
+        // All arrays the shard ever had, the current one last
+        std::vector<std::unique_ptr<BucketArray>> arrays;
+        // Erased nodes, linked through next
+        Node* freeNodes = nullptr;
+    };
+
+    static constexpr size_t INITIAL_BUCKETS = 16;
+    static constexpr float LOAD_FACTOR_THRESHOLD = 0.5f;
+
+    std::unique_ptr<Shard[]> shards;
+    size_t numShards;
+    unsigned shardBits;
+    [[no_unique_address]] Hash hasher;
+    [[no_unique_address]] Eq equal;
+
+    uint64_t hash(const K& key) const noexcept;
+    Shard& shardFor(uint64_t hash) const noexcept;
+    static void beginWrite(Shard& shard) noexcept;
+    static void endWrite(Shard& shard) noexcept;
+    template <typename Fn>
+    bool lookup(const K& key, Fn&& found) const noexcept;
+    static K keyOf(const Node& node) noexcept;
+    bool insertOrAssign(const K& key, const V& value);
+    BucketArray* grow(Shard& shard, BucketArray* old);
+
+public:
+    static constexpr size_t DEFAULT_SHARDS = 64;
+
+    // numShards is rounded up to a power of two. A few times the number of
+    // threads keeps writers apart.
+    explicit BasicConcurrentChainingHashTable(size_t numShards = DEFAULT_SHARDS);
+    ~BasicConcurrentChainingHashTable();
+    BasicConcurrentChainingHashTable(const BasicConcurrentChainingHashTable&) = delete;
+    BasicConcurrentChainingHashTable& operator=(const BasicConcurrentChainingHashTable&) = delete;
+
+    // Exact only while no writer is active
+    size_t size() const noexcept;
+    size_t shardCount() const noexcept;
+    bool contains(const K& key) const noexcept;
+    // Copy the value of key into value, which is left alone if key is missing
+    bool find(const K& key, V& value) const;
+    // Insert or assign, true if key was not in the table before
+    bool insert(const K& key, V&& value);
+    bool insert(const K& key, const V& value) requires std::copyable<V>;
+    // True if key was in the table
+    bool erase(const K& key);
+};
+
+using ConcurrentChainingHashTable = BasicConcurrentChainingHashTable<int64_t, GenericValue>;
+
+//---------------------------------------------------------------------------
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+BasicConcurrentChainingHashTable<K, V, Hash, Eq>::BasicConcurrentChainingHashTable(size_t numShards)
+    : numShards(std::bit_ceil(std::max<size_t>(1, numShards))), shardBits(static_cast<unsigned>(std::countr_zero(this->numShards))) {
+    shards = std::make_unique<Shard[]>(this->numShards);
+    for (size_t i = 0; i < this->numShards; ++i) {
+        Shard& shard = shards[i];
+        shard.arrays.push_back(std::make_unique<BucketArray>(INITIAL_BUCKETS));
+        shard.buckets.store(shard.arrays.back().get(), std::memory_order_relaxed);
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+BasicConcurrentChainingHashTable<K, V, Hash, Eq>::~BasicConcurrentChainingHashTable() {
+    for (size_t i = 0; i < numShards; ++i) {
+        Shard& shard = shards[i];
+        // every live node is in the current array exactly once
+        BucketArray* array = shard.buckets.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < array->size; ++b) {
+            for (Node* node = array->heads[b].load(std::memory_order_relaxed); node;) {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+        while (Node* node = shard.freeNodes) {
+            shard.freeNodes = node->next.load(std::memory_order_relaxed);
+            delete node;
+        }
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+uint64_t BasicConcurrentChainingHashTable<K, V, Hash, Eq>::hash(const K& key) const noexcept {
+    return static_cast<uint64_t>(hasher(key));
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+typename BasicConcurrentChainingHashTable<K, V, Hash, Eq>::Shard& BasicConcurrentChainingHashTable<K, V, Hash, Eq>::shardFor(uint64_t hash) const noexcept {
+    // the high bits, the buckets within the shard use the low ones
+    return shards[shardBits ? hash >> (64 - shardBits) : 0];
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+void BasicConcurrentChainingHashTable<K, V, Hash, Eq>::beginWrite(Shard& shard) noexcept {
+    shard.sequence.store(shard.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    // the odd sequence number becomes visible before any of the changes
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+void BasicConcurrentChainingHashTable<K, V, Hash, Eq>::endWrite(Shard& shard) noexcept {
+    shard.sequence.store(shard.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+template <typename Fn>
+bool BasicConcurrentChainingHashTable<K, V, Hash, Eq>::lookup(const K& key, Fn&& found) const noexcept {
+    uint64_t h = hash(key);
+    const Shard& shard = shardFor(h);
+    while (true) {
+        uint64_t before = shard.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        const BucketArray* array = shard.buckets.load(std::memory_order_acquire);
+        // While nodes are relinked the walk may stray into other chains; one
+        // longer than the shard cannot have been consistent
+        size_t steps = shard.numEntries.load(std::memory_order_relaxed) + 1;
+        const Node* node = array->heads[h & (array->size - 1)].load(std::memory_order_acquire);
+        bool hit = false;
+        K current;
+        for (; node && steps; node = node->next.load(std::memory_order_acquire), --steps) {
+            // current may be torn, the sequence number tells
+            node->key.load(current);
+            if (equal(current, key)) {
+                found(*node);
+                hit = true;
+                break;
+            }
+        }
+        // the reads above happen before the sequence number is checked again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (shard.sequence.load(std::memory_order_relaxed) == before && (hit || !node)) return hit;
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+K BasicConcurrentChainingHashTable<K, V, Hash, Eq>::keyOf(const Node& node) noexcept {
+    K key;
+    node.key.load(key);
+    return key;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+bool BasicConcurrentChainingHashTable<K, V, Hash, Eq>::insertOrAssign(const K& key, const V& value) {
+    uint64_t h = hash(key);
+    Shard& shard = shardFor(h);
+    std::lock_guard guard(shard.lock);
+    BucketArray* array = shard.buckets.load(std::memory_order_relaxed);
+    for (Node* node = array->heads[h & (array->size - 1)].load(std::memory_order_relaxed); node; node = node->next.load(std::memory_order_relaxed)) {
+        if (equal(keyOf(*node), key)) {
+            beginWrite(shard);
+            node->value.store(value);
+            endWrite(shard);
+            return false;
+        }
+    }
+
+    size_t entries = shard.numEntries.load(std::memory_order_relaxed);
+    if (static_cast<float>(entries + 1) > static_cast<float>(array->size) * LOAD_FACTOR_THRESHOLD) array = grow(shard, array);
+    // readers may still be in a reused node, so it only changes in the
+    // write section
+    Node* node = shard.freeNodes;
+    if (node) shard.freeNodes = node->next.load(std::memory_order_relaxed);
+    else node = new Node();
+    beginWrite(shard);
+    node->key.store(key);
+    node->value.store(value);
+    std::atomic<Node*>& head = array->heads[h & (array->size - 1)];
+    node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    head.store(node, std::memory_order_release);
+    shard.numEntries.store(entries + 1, std::memory_order_relaxed);
+    endWrite(shard);
+    return true;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+typename BasicConcurrentChainingHashTable<K, V, Hash, Eq>::BucketArray* BasicConcurrentChainingHashTable<K, V, Hash, Eq>::grow(Shard& shard, BucketArray* old) {
+    // allocate everything first, so that nothing throws in the write section
+    auto array = std::make_unique<BucketArray>(old->size * 2);
+    shard.arrays.reserve(shard.arrays.size() + 1);
+
+    beginWrite(shard);
+    // the old array keeps its heads for readers still walking it, they
+    // retry anyway
+    for (size_t b = 0; b < old->size; ++b) {
+        for (Node* node = old->heads[b].load(std::memory_order_relaxed); node;) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            std::atomic<Node*>& head = array->heads[hash(keyOf(*node)) & (array->size - 1)];
+            node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            head.store(node, std::memory_order_relaxed);
+            node = next;
+        }
+    }
+    BucketArray* result = array.get();
+    shard.buckets.store(result, std::memory_order_release);
+    shard.arrays.push_back(std::move(array));
+    endWrite(shard);
+    return result;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+size_t BasicConcurrentChainingHashTable<K, V, Hash, Eq>::size() const noexcept {
+    size_t total = 0;
+    for (size_t i = 0; i < numShards; ++i) total += shards[i].numEntries.load(std::memory_order_relaxed);
+    return total;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+size_t BasicConcurrentChainingHashTable<K, V, Hash, Eq>::shardCount() const noexcept {
+    return numShards;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+bool BasicConcurrentChainingHashTable<K, V, Hash, Eq>::contains(const K& key) const noexcept {
+    return lookup(key, [](const Node&) {});
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+bool BasicConcurrentChainingHashTable<K, V, Hash, Eq>::find(const K& key, V& value) const {
+    // the copy may be torn, it is only used once the lookup validated it
+    V copy;
+    bool hit = lookup(key, [&](const Node& node) { node.value.load(copy); });
+    if (hit) value = std::move(copy);
+    return hit;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+bool BasicConcurrentChainingHashTable<K, V, Hash, Eq>::insert(const K& key, V&& value) {
+    return insertOrAssign(key, value);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+bool BasicConcurrentChainingHashTable<K, V, Hash, Eq>::insert(const K& key, const V& value) requires std::copyable<V> {
+    return insertOrAssign(key, value);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+requires isMappable<K> && isMappable<V> && std::default_initializable<K> && std::default_initializable<V>
+bool BasicConcurrentChainingHashTable<K, V, Hash, Eq>::erase(const K& key) {
+    uint64_t h = hash(key);
+    Shard& shard = shardFor(h);
+    std::lock_guard guard(shard.lock);
+    BucketArray* array = shard.buckets.load(std::memory_order_relaxed);
+    std::atomic<Node*>* link = &array->heads[h & (array->size - 1)];
+    while (Node* node = link->load(std::memory_order_relaxed)) {
+        if (equal(keyOf(*node), key)) {
+            beginWrite(shard);
+            link->store(node->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            // readers may still be in the node, keep it for reuse
+            node->next.store(shard.freeNodes, std::memory_order_relaxed);
+            shard.freeNodes = node;
+            shard.numEntries.store(shard.numEntries.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            endWrite(shard);
+            return true;
+        }
+        link = &node->next;
+    }
+    return false;
+}
+
+// Instantiated once in ConcurrentChainingHashTable.cpp
+extern template class BasicConcurrentChainingHashTable<int64_t, GenericValue>;
+
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,10 @@
+#include "lib/DenseHashTable.hpp"
+//---------------------------------------------------------------------------
+namespace hashtable {
+//---------------------------------------------------------------------------
+
+template class BasicDenseHashTable<int64_t, GenericValue>;
+
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
@@ -0,0 +1,396 @@
+#ifndef H_lib_DenseHashTable
+#define H_lib_DenseHashTable
+//---------------------------------------------------------------------------
+#include "lib/GenericValue.hpp"
+#include "lib/Hash.hpp"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+//---------------------------------------------------------------------------
+
+namespace hashtable {
+//---------------------------------------------------------------------------
+
+// Chaining table that keeps its entries in one array in insertion order.
+// The buckets and the chain links are 32 bit indices into that array, so
+// iteration is a linear scan and lookups chase indices instead of pointers.
+// Erase leaves a hole that iteration skips; the holes are squeezed out the
+// next time the array is full. Growing moves the entries, so inserts
+// invalidate references to values, unlike in BasicChainingHashTable.
+template <typename K, typename V, KeyHasher<K> Hash = DefaultHash<K>, typename Eq = std::equal_to<K>>
+class BasicDenseHashTable {
+public:
+    struct Entry {
+        const K key;
+        V value;
+
+        template <typename KeyArg, typename... ValueArgs>
+        explicit Entry(KeyArg&& k, ValueArgs&&... v) : key(std::forward<KeyArg>(k)), value(std::forward<ValueArgs>(v)...) {}
+        Entry(const Entry&) = default;
+        // the key is const and therefore copied
+        Entry(Entry&& other) noexcept(std::is_nothrow_copy_constructible_v<K> && std::is_nothrow_move_constructible_v<V>)
+            : key(other.key), value(std::move(other.value)) {}
+    };
+
+private:
+    struct Slot {
+        // next slot in the chain, NONE at the end, ERASED for a hole
+        uint32_t next = ERASED;
+        union {
+            Entry entry;
+        };
+        Slot() {}
+        ~Slot() {}
+    };
+
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t ERASED = NONE - 1;
+    static constexpr size_t MAX_ENTRIES = ERASED;
+    static constexpr size_t MIN_CAPACITY = 8;
+
+    std::unique_ptr<Slot[]> slots;
+    // Slots [0, used) hold entries or holes
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t numEntries = 0;
+    // First slot of every chain, two buckets per slot
+    std::vector<uint32_t> buckets;
+    [[no_unique_address]] Hash hasher;
+    [[no_unique_address]] Eq equal;
+
+    size_t bucketOf(const K& key) const noexcept;
+    uint32_t findIndex(const K& key) const noexcept;
+    template <typename... ValueArgs>
+    uint32_t append(const K& key, ValueArgs&&... value);
+    void makeRoom();
+    void relocate(size_t newCapacity);
+    void destroyEntries() noexcept;
+    template <typename ValueArg>
+    V& insertOrAssign(const K& key, ValueArg&& value);
+
+public:
+    BasicDenseHashTable() = default;
+    ~BasicDenseHashTable();
+    BasicDenseHashTable(BasicDenseHashTable&& other) noexcept;
+    BasicDenseHashTable& operator=(BasicDenseHashTable&& other) noexcept;
+
+    size_t size() const noexcept;
+    // Number of holes left by erase that have not been compacted yet
+    size_t holes() const noexcept;
+    // Make room for n entries
+    void reserve(size_t n);
+    // Remove the holes now instead of on the next growth
+    void compact();
+    bool contains(const K& key) const noexcept;
+    V& operator[](const K& key);
+    V& insert(const K& key, V&& value);
+    V& insert(const K& key, const V& value) requires std::copyable<V>;
+    void erase(const K& key) noexcept;
+
+    // Visits the entries in insertion order
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Entry*;
+        using reference = Entry&;
+
+        iterator() = default;
+        // Starts at the first entry in [p, e)
+        iterator(Slot* p, Slot* e);
+
+        iterator& operator++();
+        iterator operator++(int);
+
+        pointer operator->() const;
+        reference operator*() const;
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        Slot* pos = nullptr;
+        Slot* end = nullptr;
+        void skipHoles() noexcept;
+    };
+
+    iterator begin();
+    iterator end();
+    iterator find(const K& key);
+};
+
+using DenseHashTable = BasicDenseHashTable<int64_t, GenericValue>;
+
+//---------------------------------------------------------------------------
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+BasicDenseHashTable<K, V, Hash, Eq>::~BasicDenseHashTable() {
+    destroyEntries();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+BasicDenseHashTable<K, V, Hash, Eq>::BasicDenseHashTable(BasicDenseHashTable&& other) noexcept
+    : slots(std::move(other.slots)),
+      capacity(other.capacity),
+      used(other.used),
+      numEntries(other.numEntries),
+      buckets(std::move(other.buckets)),
+      hasher(other.hasher),
+      equal(other.equal) {
+    other.buckets.clear();
+    other.capacity = 0;
+    other.used = 0;
+    other.numEntries = 0;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+BasicDenseHashTable<K, V, Hash, Eq>& BasicDenseHashTable<K, V, Hash, Eq>::operator=(BasicDenseHashTable&& other) noexcept {
+    if (this != &other) {
+        destroyEntries();
+        slots = std::move(other.slots);
+        capacity = other.capacity;
+        used = other.used;
+        numEntries = other.numEntries;
+        buckets = std::move(other.buckets);
+        hasher = other.hasher;
+        equal = other.equal;
+        other.buckets.clear();
+        other.capacity = 0;
+        other.used = 0;
+        other.numEntries = 0;
+    }
+    return *this;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+void BasicDenseHashTable<K, V, Hash, Eq>::destroyEntries() noexcept {
+    for (size_t i = 0; i < used; ++i)
+        if (slots[i].next != ERASED) slots[i].entry.~Entry();
+    used = 0;
+    numEntries = 0;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+size_t BasicDenseHashTable<K, V, Hash, Eq>::bucketOf(const K& key) const noexcept {
+    // the bucket count is a power of two
+    return static_cast<size_t>(hasher(key)) & (buckets.size() - 1);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+uint32_t BasicDenseHashTable<K, V, Hash, Eq>::findIndex(const K& key) const noexcept {
+    if (buckets.empty()) return NONE;
+    for (uint32_t i = buckets[bucketOf(key)]; i != NONE; i = slots[i].next) {
+        if (equal(slots[i].entry.key, key)) return i;
+    }
+    return NONE;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+void BasicDenseHashTable<K, V, Hash, Eq>::relocate(size_t newCapacity) {
+    if (newCapacity > MAX_ENTRIES) throw std::length_error("BasicDenseHashTable: too many entries");
+    // allocate everything first, so that a failure leaves the table untouched
+    auto newSlots = std::make_unique<Slot[]>(newCapacity);
+    std::vector<uint32_t> newBuckets(std::max<size_t>(16, 2 * newCapacity), NONE);
+
+    // Copy instead of move if a move could throw, as std::vector does
+    size_t count = 0;
+    try {
+        for (size_t i = 0; i < used; ++i) {
+            if (slots[i].next == ERASED) continue;
+            new (&newSlots[count].entry) Entry(std::move_if_noexcept(slots[i].entry));
+            newSlots[count].next = NONE;
+            ++count;
+        }
+    } catch (...) {
+        for (size_t i = 0; i < count; ++i) newSlots[i].entry.~Entry();
+        throw;
+    }
+
+    destroyEntries();
+    slots = std::move(newSlots);
+    buckets = std::move(newBuckets);
+    capacity = newCapacity;
+    used = count;
+    numEntries = count;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t& head = buckets[bucketOf(slots[i].entry.key)];
+        slots[i].next = head;
+        head = static_cast<uint32_t>(i);
+    }
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+void BasicDenseHashTable<K, V, Hash, Eq>::makeRoom() {
+    // Squeeze out the holes if they are a quarter of the array, grow otherwise
+    if (capacity > 0 && (used - numEntries) * 4 >= capacity)
+        relocate(capacity);
+    else
+        relocate(std::max(MIN_CAPACITY, capacity * 2));
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+template <typename... ValueArgs>
+uint32_t BasicDenseHashTable<K, V, Hash, Eq>::append(const K& key, ValueArgs&&... value) {
+    if (used == capacity) makeRoom();
+    auto index = static_cast<uint32_t>(used);
+    Slot& slot = slots[index];
+    new (&slot.entry) Entry(key, std::forward<ValueArgs>(value)...);
+    uint32_t& head = buckets[bucketOf(key)];
+    slot.next = head;
+    head = index;
+    ++used;
+    ++numEntries;
+    return index;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+size_t BasicDenseHashTable<K, V, Hash, Eq>::size() const noexcept {
+    return numEntries;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+size_t BasicDenseHashTable<K, V, Hash, Eq>::holes() const noexcept {
+    return used - numEntries;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+void BasicDenseHashTable<K, V, Hash, Eq>::reserve(size_t n) {
+    if (n > capacity) relocate(std::max(MIN_CAPACITY, std::bit_ceil(n)));
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+void BasicDenseHashTable<K, V, Hash, Eq>::compact() {
+    if (used != numEntries) relocate(capacity);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+bool BasicDenseHashTable<K, V, Hash, Eq>::contains(const K& key) const noexcept {
+    return findIndex(key) != NONE;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+V& BasicDenseHashTable<K, V, Hash, Eq>::operator[](const K& key) {
+    uint32_t index = findIndex(key);
+    if (index == NONE) index = append(key);
+    return slots[index].entry.value;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+template <typename ValueArg>
+V& BasicDenseHashTable<K, V, Hash, Eq>::insertOrAssign(const K& key, ValueArg&& value) {
+    uint32_t index = findIndex(key);
+    if (index != NONE) {
+        slots[index].entry.value = std::forward<ValueArg>(value);
+        return slots[index].entry.value;
+    }
+    return slots[append(key, std::forward<ValueArg>(value))].entry.value;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+V& BasicDenseHashTable<K, V, Hash, Eq>::insert(const K& key, V&& value) {
+    return insertOrAssign(key, std::move(value));
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+V& BasicDenseHashTable<K, V, Hash, Eq>::insert(const K& key, const V& value) requires std::copyable<V> {
+    return insertOrAssign(key, value);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+void BasicDenseHashTable<K, V, Hash, Eq>::erase(const K& key) noexcept {
+    if (buckets.empty()) return;
+    for (uint32_t* next = &buckets[bucketOf(key)]; *next != NONE; next = &slots[*next].next) {
+        Slot& slot = slots[*next];
+        if (equal(slot.entry.key, key)) {
+            *next = slot.next;
+            slot.entry.~Entry();
+            slot.next = ERASED;
+            --numEntries;
+            return;
+        }
+    }
+}
+
+//--------------------------iterator------------------------------------
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+BasicDenseHashTable<K, V, Hash, Eq>::iterator::iterator(Slot* p, Slot* e) : pos(p), end(e) {
+    skipHoles();
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+void BasicDenseHashTable<K, V, Hash, Eq>::iterator::skipHoles() noexcept {
+    while (pos != end && pos->next == ERASED) ++pos;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+typename BasicDenseHashTable<K, V, Hash, Eq>::iterator BasicDenseHashTable<K, V, Hash, Eq>::begin() {
+    return iterator(slots.get(), slots.get() + used);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+typename BasicDenseHashTable<K, V, Hash, Eq>::iterator BasicDenseHashTable<K, V, Hash, Eq>::end() {
+    return iterator(slots.get() + used, slots.get() + used);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+typename BasicDenseHashTable<K, V, Hash, Eq>::iterator BasicDenseHashTable<K, V, Hash, Eq>::find(const K& key) {
+    uint32_t index = findIndex(key);
+    if (index == NONE) return end();
+    return iterator(slots.get() + index, slots.get() + used);
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+typename BasicDenseHashTable<K, V, Hash, Eq>::iterator& BasicDenseHashTable<K, V, Hash, Eq>::iterator::operator++() {
+    if (pos == end) return *this;
+    ++pos;
+    skipHoles();
+    return *this;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+typename BasicDenseHashTable<K, V, Hash, Eq>::iterator BasicDenseHashTable<K, V, Hash, Eq>::iterator::operator++(int) {
+    iterator tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+typename BasicDenseHashTable<K, V, Hash, Eq>::iterator::reference BasicDenseHashTable<K, V, Hash, Eq>::iterator::operator*() const {
+    return pos->entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+typename BasicDenseHashTable<K, V, Hash, Eq>::iterator::pointer BasicDenseHashTable<K, V, Hash, Eq>::iterator::operator->() const {
+    return &pos->entry;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+bool BasicDenseHashTable<K, V, Hash, Eq>::iterator::operator==(const iterator& other) const {
+    return pos == other.pos;
+}
+
+template <typename K, typename V, KeyHasher<K> Hash, typename Eq>
+bool BasicDenseHashTable<K, V, Hash, Eq>::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
+
+// Instantiated once in DenseHashTable.cpp
+extern template class BasicDenseHashTable<int64_t, GenericValue>;
+
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
+#endif
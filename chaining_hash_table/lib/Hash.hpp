@@ -0,0 +1,45 @@
+#ifndef H_lib_Hash
+#define H_lib_Hash
+//---------------------------------------------------------------------------
+#include <concepts>
+#include <cstdint>
+#include <functional>
+//---------------------------------------------------------------------------
+
+namespace hashtable {
+//---------------------------------------------------------------------------
+
+// Hash function for the tables. The tables take the bucket or slot index from
+// the low bits of the result, so every bit of the key has to reach them.
+template <typename H, typename K = int64_t>
+concept KeyHasher = std::default_initializable<H> && requires(const H& h, const K& key) {
+    { h(key) } -> std::convertible_to<uint64_t>;
+};
+
+// Multiply-xorshift mixer. std::hash<int64_t> is the identity on libstdc++,
+// so strided keys such as multiples of 1024 would share a few buckets.
+struct MixHash {
+    uint64_t operator()(int64_t key) const noexcept {
+        auto h = static_cast<uint64_t>(key);
+        h ^= h >> 32;
+        h *= 0xd6e8feb86659fd93ull;
+        h ^= h >> 32;
+        h *= 0xd6e8feb86659fd93ull;
+        h ^= h >> 32;
+        return h;
+    }
+};
+
+// Hash for any key with a std::hash specialization. The result of std::hash
+// is mixed as well, so DefaultHash<int64_t> gives the same values as MixHash.
+template <typename K>
+struct DefaultHash {
+    uint64_t operator()(const K& key) const noexcept {
+        return MixHash{}(static_cast<int64_t>(std::hash<K>{}(key)));
+    }
+};
+
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
+#endif
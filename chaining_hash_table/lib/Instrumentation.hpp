@@ -0,0 +1,78 @@
+#ifndef H_lib_Instrumentation
+#define H_lib_Instrumentation
+//---------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+//---------------------------------------------------------------------------
+namespace hashtable::detail {
+//---------------------------------------------------------------------------
+#if defined(CHAINING_HT_STATISTICS)
+// Counters behind the statistics of a table. Lookups from several threads
+// may count at once, so the counters are relaxed atomics and the probe
+// average is approximate under contention.
+class Instrumentation {
+public:
+    static constexpr bool enabled = true;
+
+    Instrumentation() = default;
+    Instrumentation(const Instrumentation& other) noexcept
+        : rehashes(other.rehashes.load(std::memory_order_relaxed)),
+          sampledLookups(other.sampledLookups.load(std::memory_order_relaxed)),
+          sampledProbes(other.sampledProbes.load(std::memory_order_relaxed)) {}
+    Instrumentation& operator=(const Instrumentation& other) noexcept {
+        rehashes.store(other.rehashes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        sampledLookups.store(other.sampledLookups.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        sampledProbes.store(other.sampledProbes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void countRehash() noexcept { rehashes.fetch_add(1, std::memory_order_relaxed); }
+    // Count the entries compared by a lookup, for one in PROBE_SAMPLE_RATE
+    // lookups of every thread
+    void countLookup(size_t probes) noexcept {
+        thread_local uint32_t lookups = 0;
+        if ((++lookups & (PROBE_SAMPLE_RATE - 1)) != 0) return;
+        uint64_t count = sampledLookups.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint64_t total = sampledProbes.fetch_add(probes, std::memory_order_relaxed) + probes;
+        if (count >= PROBE_WINDOW) {
+            // halve both, so that older lookups fade out
+            sampledLookups.store(count / 2, std::memory_order_relaxed);
+            sampledProbes.store(total / 2, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t getRehashes() const noexcept { return rehashes.load(std::memory_order_relaxed); }
+    // 0 if no lookup was sampled yet
+    double getAverageProbeLength() const noexcept {
+        uint64_t count = sampledLookups.load(std::memory_order_relaxed);
+        return count ? static_cast<double>(sampledProbes.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+    }
+
+private:
+    // Power of two
+    static constexpr uint32_t PROBE_SAMPLE_RATE = 64;
+    // Sampled lookups that make up the recent average
+    static constexpr uint64_t PROBE_WINDOW = 1 << 12;
+
+    std::atomic<uint64_t> rehashes{0};
+    std::atomic<uint64_t> sampledLookups{0};
+    std::atomic<uint64_t> sampledProbes{0};
+};
+#else
+// Built without CHAINING_HT_STATISTICS: nothing is counted, and the calls
+// compile to nothing
+class Instrumentation {
+public:
+    static constexpr bool enabled = false;
+
+    void countRehash() noexcept {}
+    void countLookup(size_t) noexcept {}
+    uint64_t getRehashes() const noexcept { return 0; }
+    double getAverageProbeLength() const noexcept { return 0.0; }
+};
+#endif
+//---------------------------------------------------------------------------
+} // namespace hashtable::detail
+//---------------------------------------------------------------------------
+#endif
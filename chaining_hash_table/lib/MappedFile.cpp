@@ -0,0 +1,58 @@
+#include "lib/MappedFile.hpp"
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+using namespace std;
+//---------------------------------------------------------------------------
+namespace hashtable {
+//---------------------------------------------------------------------------
+MappedFile::MappedFile(const string& path)
+// Map a file
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Cannot open " + path);
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        throw runtime_error("Cannot map empty file " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    // MAP_PRIVATE makes written pages private copies, the file stays as it is
+    void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (result == MAP_FAILED) throw runtime_error("Cannot map " + path);
+    mapping = result;
+    mappingSize = size;
+}
+//---------------------------------------------------------------------------
+MappedFile::~MappedFile()
+// Destructor
+{
+    if (mapping) munmap(mapping, mappingSize);
+}
+//---------------------------------------------------------------------------
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping(exchange(other.mapping, nullptr)), mappingSize(exchange(other.mappingSize, 0))
+// Move constructor
+{
+}
+//---------------------------------------------------------------------------
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+// Move assignment
+{
+    if (this == &other)
+        return *this;
+
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = exchange(other.mapping, nullptr);
+    mappingSize = exchange(other.mappingSize, 0);
+
+    return *this;
+}
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
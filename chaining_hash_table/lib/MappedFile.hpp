@@ -0,0 +1,54 @@
+#ifndef H_lib_MappedFile
+#define H_lib_MappedFile
+//---------------------------------------------------------------------------
+#include "lib/GenericValue.hpp"
+#include <cstddef>
+#include <string>
+#include <type_traits>
+//---------------------------------------------------------------------------
+namespace hashtable {
+//---------------------------------------------------------------------------
+/// Types that can be written to a file byte by byte and used in place from a
+/// mapping of it: no pointers, no owned resources, nothing to destroy
+template <typename T>
+inline constexpr bool isMappable = std::is_trivially_copyable_v<T>;
+/// A generic value is 64 plain bytes
+template <>
+inline constexpr bool isMappable<GenericValue> = true;
+//---------------------------------------------------------------------------
+/// Private mapping of a whole file. The mapping is writable, but writes go
+/// to copy-on-write pages of the process and never reach the file.
+class MappedFile {
+    private:
+    /// The mapping, nullptr if nothing is mapped
+    void* mapping = nullptr;
+    /// The size of the mapping
+    size_t mappingSize = 0;
+
+    public:
+    /// Construct without a mapping
+    MappedFile() = default;
+    /// Map a file, throws std::runtime_error if it cannot be mapped
+    explicit MappedFile(const std::string& path);
+    /// Destructor
+    ~MappedFile();
+
+    /// Mappings can't be copied
+    MappedFile(const MappedFile&) = delete;
+    /// Mappings can't be copied
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Move constructor
+    MappedFile(MappedFile&& other) noexcept;
+    /// Move assignment
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// The first byte of the file, nullptr if nothing is mapped
+    std::byte* data() const { return static_cast<std::byte*>(mapping); }
+    /// The size of the file
+    size_t size() const { return mappingSize; }
+};
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,285 @@
+#include "lib/SwissHashTable.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <new>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+//---------------------------------------------------------------------------
+namespace hashtable {
+//---------------------------------------------------------------------------
+
+namespace {
+
+constexpr size_t groupWidth = 16;
+constexpr size_t initialSlots = 16;
+constexpr int8_t ctrlEmpty = -128;
+constexpr int8_t ctrlDeleted = -2;
+
+// Bit i is set if control byte i of the group matches
+using Mask = uint16_t;
+
+Mask matchByte(const int8_t* group, int8_t value) noexcept {
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+    Mask mask = 0;
+    for (size_t i = 0; i < groupWidth; ++i)
+        if (group[i] == value) mask |= static_cast<Mask>(1u << i);
+    return mask;
+#endif
+}
+
+Mask matchEmpty(const int8_t* group) noexcept {
+    return matchByte(group, ctrlEmpty);
+}
+
+// Empty and deleted are the only negative control bytes
+Mask matchEmptyOrDeleted(const int8_t* group) noexcept {
+#if defined(__SSE2__)
+    return static_cast<Mask>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+    Mask mask = 0;
+    for (size_t i = 0; i < groupWidth; ++i)
+        if (group[i] < 0) mask |= static_cast<Mask>(1u << i);
+    return mask;
+#endif
+}
+
+size_t maxLoad(size_t numSlots) noexcept {
+    return numSlots - numSlots / 8;
+}
+
+} // namespace
+
+SwissHashTable::SwissHashTable() {
+    resize(initialSlots);
+}
+
+SwissHashTable::~SwissHashTable() {
+    destroyEntries();
+}
+
+SwissHashTable::SwissHashTable(SwissHashTable&& other) noexcept
+    : ctrl(std::move(other.ctrl)),
+      slots(std::move(other.slots)),
+      numSlots(other.numSlots),
+      numEntries(other.numEntries),
+      numDeleted(other.numDeleted) {
+    other.numSlots = 0;
+    other.numEntries = 0;
+    other.numDeleted = 0;
+}
+
+SwissHashTable& SwissHashTable::operator=(SwissHashTable&& other) noexcept {
+    if (this != &other) {
+        destroyEntries();
+        ctrl = std::move(other.ctrl);
+        slots = std::move(other.slots);
+        numSlots = other.numSlots;
+        numEntries = other.numEntries;
+        numDeleted = other.numDeleted;
+        other.numSlots = 0;
+        other.numEntries = 0;
+        other.numDeleted = 0;
+    }
+    return *this;
+}
+
+uint64_t SwissHashTable::hash(int64_t key) noexcept {
+    // The control bytes use the low 7 bits, the probe start the bits above
+    return MixHash{}(key);
+}
+
+void SwissHashTable::setCtrl(size_t index, int8_t value) noexcept {
+    ctrl[index] = value;
+    if (index < groupWidth) ctrl[numSlots + index] = value;
+}
+
+void SwissHashTable::destroyEntries() noexcept {
+    for (size_t i = nextFull(0); i < numSlots; i = nextFull(i + 1))
+        slots[i].entry.~Entry();
+}
+
+size_t SwissHashTable::findSlot(int64_t key, uint64_t h) const noexcept {
+    if (numSlots == 0) return numSlots;
+    size_t mask = numSlots - 1;
+    auto tag = static_cast<int8_t>(h & 0x7F);
+    // Triangular probing over groups visits every slot for power-of-two sizes
+    size_t pos = (h >> 7) & mask;
+    for (size_t step = groupWidth;; step += groupWidth) {
+        const int8_t* group = ctrl.get() + pos;
+        for (Mask m = matchByte(group, tag); m; m &= m - 1) {
+            size_t index = (pos + std::countr_zero(m)) & mask;
+            if (slots[index].entry.key == key) return index;
+        }
+        if (matchEmpty(group)) return numSlots;
+        pos = (pos + step) & mask;
+    }
+}
+
+size_t SwissHashTable::findFirstNonFull(uint64_t h) const noexcept {
+    size_t mask = numSlots - 1;
+    size_t pos = (h >> 7) & mask;
+    for (size_t step = groupWidth;; step += groupWidth) {
+        if (Mask m = matchEmptyOrDeleted(ctrl.get() + pos)) return (pos + std::countr_zero(m)) & mask;
+        pos = (pos + step) & mask;
+    }
+}
+
+size_t SwissHashTable::nextFull(size_t index) const noexcept {
+    while (index < numSlots) {
+        // Full bytes are the non-negative ones
+        Mask full = static_cast<Mask>(~matchEmptyOrDeleted(ctrl.get() + index));
+        if (full) return std::min(numSlots, index + std::countr_zero(full));
+        index += groupWidth;
+    }
+    return numSlots;
+}
+
+void SwissHashTable::resize(size_t newNumSlots) {
+    auto newCtrl = std::make_unique<int8_t[]>(newNumSlots + groupWidth);
+    auto newSlots = std::make_unique<Slot[]>(newNumSlots);
+    std::memset(newCtrl.get(), ctrlEmpty, newNumSlots + groupWidth);
+
+    auto oldCtrl = std::move(ctrl);
+    auto oldSlots = std::move(slots);
+    size_t oldNumSlots = numSlots;
+    ctrl = std::move(newCtrl);
+    slots = std::move(newSlots);
+    numSlots = newNumSlots;
+    numDeleted = 0;
+
+    for (size_t i = 0; i < oldNumSlots; ++i) {
+        if (oldCtrl[i] < 0) continue;
+        Entry& entry = oldSlots[i].entry;
+        uint64_t h = hash(entry.key);
+        size_t index = findFirstNonFull(h);
+        setCtrl(index, static_cast<int8_t>(h & 0x7F));
+        new (&slots[index].entry) Entry(entry.key, std::move(entry.value));
+        entry.~Entry();
+    }
+}
+
+size_t SwissHashTable::prepareInsert(uint64_t h) {
+    if (numSlots == 0) {
+        resize(initialSlots);
+    } else if (numEntries + numDeleted + 1 > maxLoad(numSlots)) {
+        // Enough tombstones to make room: clean up in place instead of growing
+        if ((numEntries + 1) * 32 <= numSlots * 25) resize(numSlots);
+        else resize(numSlots * 2);
+    }
+    size_t index = findFirstNonFull(h);
+    if (ctrl[index] == ctrlDeleted) --numDeleted;
+    setCtrl(index, static_cast<int8_t>(h & 0x7F));
+    ++numEntries;
+    return index;
+}
+
+size_t SwissHashTable::size() const noexcept {
+    return numEntries;
+}
+
+size_t SwissHashTable::capacity() const noexcept {
+    return numSlots;
+}
+
+bool SwissHashTable::contains(int64_t key) const noexcept {
+    return findSlot(key, hash(key)) != numSlots;
+}
+
+GenericValue& SwissHashTable::operator[](int64_t key) {
+    uint64_t h = hash(key);
+    size_t index = findSlot(key, h);
+    if (index != numSlots) return slots[index].entry.value;
+
+    index = prepareInsert(h);
+    new (&slots[index].entry) Entry(key, GenericValue());
+    return slots[index].entry.value;
+}
+
+GenericValue& SwissHashTable::insert(int64_t key, GenericValue&& value) {
+    uint64_t h = hash(key);
+    size_t index = findSlot(key, h);
+    if (index != numSlots) {
+        slots[index].entry.value = std::move(value);
+        return slots[index].entry.value;
+    }
+
+    index = prepareInsert(h);
+    new (&slots[index].entry) Entry(key, std::move(value));
+    return slots[index].entry.value;
+}
+
+void SwissHashTable::erase(int64_t key) noexcept {
+    size_t index = findSlot(key, hash(key));
+    if (index == numSlots) return;
+    slots[index].entry.~Entry();
+    --numEntries;
+
+    // If no group that contains the slot was ever seen full, no probe can
+    // have continued past it and the slot can become empty again
+    size_t mask = numSlots - 1;
+    Mask emptyAfter = matchEmpty(ctrl.get() + index);
+    Mask emptyBefore = matchEmpty(ctrl.get() + ((index - groupWidth) & mask));
+    bool wasNeverFull = emptyBefore && emptyAfter
+        && static_cast<size_t>(std::countr_zero(emptyAfter) + std::countl_zero(emptyBefore)) < groupWidth;
+    if (wasNeverFull) {
+        setCtrl(index, ctrlEmpty);
+    } else {
+        setCtrl(index, ctrlDeleted);
+        ++numDeleted;
+    }
+}
+
+//--------------------------iterator------------------------------------
+
+SwissHashTable::iterator::iterator(SwissHashTable* t, size_t i)
+    : table(t), index(i) {}
+
+SwissHashTable::iterator SwissHashTable::begin() {
+    return iterator(this, nextFull(0));
+}
+
+SwissHashTable::iterator SwissHashTable::end() {
+    return iterator(this, numSlots);
+}
+
+SwissHashTable::iterator SwissHashTable::find(int64_t key) {
+    return iterator(this, findSlot(key, hash(key)));
+}
+
+SwissHashTable::iterator& SwissHashTable::iterator::operator++() {
+    if (table && index < table->numSlots) index = table->nextFull(index + 1);
+    return *this;
+}
+
+SwissHashTable::iterator SwissHashTable::iterator::operator++(int) {
+    iterator tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+SwissHashTable::iterator::reference SwissHashTable::iterator::operator*() const {
+    return table->slots[index].entry;
+}
+
+SwissHashTable::iterator::pointer SwissHashTable::iterator::operator->() const {
+    return &table->slots[index].entry;
+}
+
+bool SwissHashTable::iterator::operator==(const iterator& other) const {
+    return table == other.table && index == other.index;
+}
+
+bool SwissHashTable::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
+
+//---------------------------------------------------------------------------
+
+} // namespace hashtable
+//---------------------------------------------------------------------------
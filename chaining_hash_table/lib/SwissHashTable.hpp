@@ -0,0 +1,104 @@
+#ifndef H_lib_SwissHashTable
+#define H_lib_SwissHashTable
+//---------------------------------------------------------------------------
+#include "lib/GenericValue.hpp"
+#include "lib/Hash.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+//---------------------------------------------------------------------------
+
+namespace hashtable {
+//---------------------------------------------------------------------------
+
+struct HashEntry {
+    const int64_t key;
+    GenericValue value;
+    HashEntry(int64_t k, GenericValue&& v) : key(k), value(std::move(v)) {}
+    // deleted copy to emphasize const key, but default move is fine for value handled explicitly
+    HashEntry(const HashEntry&) = delete;
+    HashEntry& operator=(const HashEntry&) = delete;
+};
+
+// Open-addressing table with the interface of ChainingHashTable. Every slot
+// has one control byte: empty, deleted (tombstone), or the low 7 bits of the
+// key's hash. Lookups compare 16 control bytes at once and only touch slots
+// whose byte matches. The capacity is a power of two and at most 7/8 of the
+// slots are in use.
+class SwissHashTable {
+public:
+    using Entry = HashEntry;
+
+private:
+    union Slot {
+        Entry entry;
+        Slot() {}
+        ~Slot() {}
+    };
+
+    // ctrl has numSlots + 16 bytes, the last 16 mirror the first 16 so that
+    // a group can be loaded at any slot index
+    std::unique_ptr<int8_t[]> ctrl;
+    std::unique_ptr<Slot[]> slots;
+    size_t numSlots = 0;
+    size_t numEntries = 0;
+    size_t numDeleted = 0;
+
+    static uint64_t hash(int64_t key) noexcept;
+    size_t findSlot(int64_t key, uint64_t h) const noexcept;
+    size_t findFirstNonFull(uint64_t h) const noexcept;
+    size_t prepareInsert(uint64_t h);
+    size_t nextFull(size_t index) const noexcept;
+    void setCtrl(size_t index, int8_t value) noexcept;
+    void resize(size_t newNumSlots);
+    void destroyEntries() noexcept;
+
+public:
+    SwissHashTable();
+    ~SwissHashTable();
+    SwissHashTable(SwissHashTable&& other) noexcept;
+    SwissHashTable& operator=(SwissHashTable&& other) noexcept;
+
+    size_t size() const noexcept;
+    size_t capacity() const noexcept;
+    bool contains(int64_t key) const noexcept;
+    GenericValue& operator[](int64_t key);
+    GenericValue& insert(int64_t key, GenericValue&& value);
+    void erase(int64_t key) noexcept;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Entry*;
+        using reference = Entry&;
+
+        iterator() = default;
+        iterator(SwissHashTable* t, size_t i);
+
+        iterator& operator++();
+        iterator operator++(int);
+
+        pointer operator->() const;
+        reference operator*() const;
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        SwissHashTable* table = nullptr;
+        size_t index = 0;
+    };
+
+    iterator begin();
+    iterator end();
+    iterator find(int64_t key);
+};
+
+//---------------------------------------------------------------------------
+} // namespace hashtable
+//---------------------------------------------------------------------------
+#endif
@@ -1,9 +1,20 @@
 #include "lib/ChainingHashTable.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#include <unistd.h>
 #include <gtest/gtest.h>
 //---------------------------------------------------------------------------
 using namespace hashtable;
@@ -21,6 +32,18 @@ static int asInt(const GenericValue& gv) {
     return value;
 }
 //---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+class TempFile {
+    public:
+    string path;
+
+    explicit TempFile(const string& name) : path((filesystem::temp_directory_path() / ("chaining_ht_" + name + "_" + to_string(getpid()) + ".bin")).string()) {}
+    ~TempFile() { remove(path.c_str()); }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
 TEST(TestChainingHashTable, EntryKeyIsConst) {
     ASSERT_TRUE(is_const_v<decltype(ChainingHashTable::Entry::key)>);
 }
@@ -192,6 +215,160 @@ TEST(TestChainingHashTable, Find) {
     }
 }
 //---------------------------------------------------------------------------
+TEST(TestChainingHashTable, IncrementalRehashKeepsEntriesVisible) {
+    ChainingHashTable ht(ChainingHashTable::RehashMode::Incremental);
+    bool sawRehash = false;
+    for (int i = 0; i < 5000; ++i) {
+        SCOPED_TRACE(i);
+        ht.insert(i * 7, GV(i));
+        sawRehash |= ht.isRehashing();
+        ASSERT_EQ(ht.size(), i + 1);
+        // every key stays reachable while buckets are being migrated
+        if (i % 97 == 0) {
+            for (int j = 0; j <= i; ++j) ASSERT_TRUE(ht.contains(j * 7));
+        }
+    }
+    EXPECT_TRUE(sawRehash);
+    for (int i = 0; i < 5000; ++i) {
+        auto it = ht.find(i * 7);
+        ASSERT_NE(it, ht.end());
+        EXPECT_EQ(asInt(it->value), i);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, IncrementalRehashFinishes) {
+    ChainingHashTable ht(ChainingHashTable::RehashMode::Incremental);
+    for (int i = 0; i < 1000; ++i) ht.insert(i, GV(i));
+    for (int i = 0; i < 1000 && ht.isRehashing(); ++i) ht.find(i);
+    EXPECT_FALSE(ht.isRehashing());
+    EXPECT_EQ(ht.size(), 1000);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, IncrementalRehashEraseAndIterate) {
+    ChainingHashTable ht(ChainingHashTable::RehashMode::Incremental);
+    // Stop right after a rehash started
+    int n = 0;
+    while (!ht.isRehashing() || n < 100) ht.insert(n, GV(n)), ++n;
+    ASSERT_TRUE(ht.isRehashing());
+
+    for (int i = 0; i < n; i += 2) ht.erase(i);
+    ht[1] = GV(1001);
+    ht[2 * n + 1] = GV(n);
+
+    set<int64_t> seen;
+    for (auto it = ht.begin(); it != ht.end(); ++it) {
+        EXPECT_EQ(it->key % 2, 1);
+        EXPECT_TRUE(seen.insert(it->key).second);
+    }
+    EXPECT_EQ(seen.size(), ht.size());
+    EXPECT_EQ(asInt(ht[1]), 1001);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, IncrementalRehashFindWhileIterating) {
+    ChainingHashTable ht(ChainingHashTable::RehashMode::Incremental);
+    int n = 0;
+    while (!ht.isRehashing() || n < 100) ht.insert(n, GV(n)), ++n;
+    ASSERT_TRUE(ht.isRehashing());
+
+    // every find migrates buckets under the iterator, until the rehash is done
+    set<int64_t> seen;
+    for (auto it = ht.begin(); it != ht.end(); ++it) {
+        EXPECT_TRUE(seen.insert(it->key).second) << it->key;
+        ht.find(it->key + 1);
+    }
+    EXPECT_FALSE(ht.isRehashing());
+    EXPECT_EQ(seen.size(), ht.size());
+
+    // an iterator returned by find continues through the moved buckets too
+    while (!ht.isRehashing()) ht.insert(n, GV(n)), ++n;
+    seen.clear();
+    for (auto it = ht.find(ht.begin()->key); it != ht.end(); ++it) {
+        EXPECT_TRUE(seen.insert(it->key).second) << it->key;
+        ht.find(-1);
+    }
+    EXPECT_EQ(seen.size(), ht.size());
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, IncrementalRehashMove) {
+    ChainingHashTable ht1(ChainingHashTable::RehashMode::Incremental);
+    int n = 0;
+    while (!ht1.isRehashing()) ht1.insert(n, GV(n)), ++n;
+
+    ChainingHashTable ht2(std::move(ht1));
+    EXPECT_TRUE(ht2.isRehashing());
+    for (int i = 0; i < n; ++i) ASSERT_TRUE(ht2.contains(i));
+    for (int i = n; i < 10 * n; ++i) ht2.insert(i, GV(i));
+    for (int i = 0; i < 10 * n; ++i) ASSERT_EQ(asInt(ht2.find(i)->value), i);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, RehashKeepsReferencesValid) {
+    for (auto mode : {ChainingHashTable::RehashMode::Blocking, ChainingHashTable::RehashMode::Incremental}) {
+        ChainingHashTable ht(mode);
+        vector<GenericValue*> values;
+        for (int i = 0; i < 100; ++i) values.push_back(&ht.insert(i, GV(i)));
+        // several resizes relink the nodes but never move the entries
+        for (int i = 100; i < 10000; ++i) ht.insert(i, GV(i));
+        for (int i = 0; i < 100 && ht.isRehashing(); ++i) ht.find(i);
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_EQ(values[i], &ht[i]);
+            ASSERT_EQ(asInt(*values[i]), i);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, Reserve) {
+    ChainingHashTable ht;
+    ht.insert(-1, GV(-1));
+    ht.reserve(10000);
+    size_t buckets = ht.bucketCount();
+    EXPECT_GE(static_cast<float>(buckets) * 0.5f, 10000);
+    for (int i = 0; i < 9999; ++i) ht.insert(i, GV(i));
+    EXPECT_EQ(ht.bucketCount(), buckets);
+    EXPECT_EQ(asInt(ht[-1]), -1);
+    // reserving less than the current size never shrinks
+    ht.reserve(10);
+    EXPECT_EQ(ht.bucketCount(), buckets);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, BulkLoadMatchesInsert) {
+    for (unsigned threads : {1u, 3u, 8u}) {
+        SCOPED_TRACE(threads);
+        // more than enough entries to use every thread, with duplicate keys
+        vector<pair<int64_t, GenericValue>> entries;
+        for (int i = 0; i < 200000; ++i) entries.emplace_back((i * 7919) % 150000, GV(i));
+
+        ChainingHashTable ht(entries, threads);
+        ChainingHashTable expected;
+        for (int i = 0; i < 200000; ++i) expected.insert((i * 7919) % 150000, GV(i));
+
+        ASSERT_EQ(ht.size(), expected.size());
+        for (auto& entry : expected) {
+            auto it = ht.find(entry.key);
+            ASSERT_NE(it, ht.end());
+            ASSERT_EQ(asInt(it->value), asInt(entry.value));
+        }
+        // the table is sized once and keeps working as usual
+        EXPECT_GE(static_cast<float>(ht.bucketCount()) * 0.5f, ht.size());
+        ht.insert(-5, GV(5));
+        EXPECT_EQ(asInt(ht[-5]), 5);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, BulkLoadSmall) {
+    vector<pair<int64_t, GenericValue>> entries;
+    ChainingHashTable empty(entries);
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+
+    entries.emplace_back(1, GV(10));
+    entries.emplace_back(2, GV(20));
+    entries.emplace_back(1, GV(30));
+    ChainingHashTable ht(entries, 4);
+    EXPECT_EQ(ht.size(), 2);
+    EXPECT_EQ(asInt(ht[1]), 30);
+    EXPECT_EQ(asInt(ht[2]), 20);
+}
+//---------------------------------------------------------------------------
 TEST(TestChainingHashTable, DestructorIsNotRecursive) {
     unique_ptr<ChainingHashTable> ht = make_unique<ChainingHashTable>();
 
@@ -205,3 +382,318 @@ TEST(TestChainingHashTable, DestructorIsNotRecursive) {
 }
 //---------------------------------------------------------------------------
 
+TEST(TestChainingHashTable, EntryLayout) {
+    // link, key and value without padding
+    EXPECT_EQ(sizeof(BasicChainingHashTable<int64_t, int64_t>::Entry), 24);
+    EXPECT_EQ(sizeof(BasicChainingHashTable<int32_t, int32_t>::Entry), 16);
+    EXPECT_EQ(sizeof(ChainingHashTable::Entry), 80);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, StringKeys) {
+    BasicChainingHashTable<string, int64_t> ht;
+    for (int64_t i = 0; i < 1000; ++i) ht.insert("key" + to_string(i), i);
+    EXPECT_EQ(ht.size(), 1000);
+    for (int64_t i = 0; i < 1000; ++i) EXPECT_EQ(ht["key" + to_string(i)], i);
+    EXPECT_FALSE(ht.contains("key1000"));
+
+    const int64_t value = 42;
+    ht.insert("key1", value);
+    EXPECT_EQ(ht.size(), 1000);
+    EXPECT_EQ(ht.find("key1")->value, 42);
+    ht.erase("key1");
+    EXPECT_FALSE(ht.contains("key1"));
+    EXPECT_EQ(ht.size(), 999);
+}
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+struct CaseInsensitiveHash {
+    uint64_t operator()(const string& key) const noexcept {
+        string lower;
+        for (char c : key) lower += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        return DefaultHash<string>{}(lower);
+    }
+};
+//---------------------------------------------------------------------------
+struct CaseInsensitiveEqual {
+    bool operator()(const string& a, const string& b) const noexcept {
+        return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                   return tolower(static_cast<unsigned char>(x)) == tolower(static_cast<unsigned char>(y));
+               });
+    }
+};
+//---------------------------------------------------------------------------
+size_t liveAllocations = 0;
+//---------------------------------------------------------------------------
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+    T* allocate(size_t n) {
+        ++liveAllocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        --liveAllocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+    bool operator==(const CountingAllocator&) const = default;
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, CustomEquality) {
+    BasicChainingHashTable<string, int, CaseInsensitiveHash, CaseInsensitiveEqual> ht;
+    ht.insert("Hello", 1);
+    ht.insert("HELLO", 2);
+    EXPECT_EQ(ht.size(), 1);
+    EXPECT_EQ(ht["hello"], 2);
+    EXPECT_EQ(ht.begin()->key, "Hello");
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, CustomAllocator) {
+    using Table = BasicChainingHashTable<int64_t, int64_t, DefaultHash<int64_t>, std::equal_to<int64_t>, CountingAllocator<pair<const int64_t, int64_t>>>;
+    {
+        Table ht(Table::RehashMode::Incremental);
+        for (int64_t i = 0; i < 1000; ++i) ht.insert(i, i);
+        for (int64_t i = 0; i < 1000; i += 2) ht.erase(i);
+        EXPECT_GT(liveAllocations, 500);
+        Table moved(std::move(ht));
+        EXPECT_EQ(moved.size(), 500);
+    }
+    EXPECT_EQ(liveAllocations, 0);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, ContainsMany) {
+    ChainingHashTable ht(ChainingHashTable::RehashMode::Incremental);
+    // stop in the middle of a rehash, with entries in old and new buckets
+    set<int64_t> inserted;
+    for (int64_t i = 0; inserted.size() < 300 || !ht.isRehashing(); i += 2) {
+        ht.insert(i, GV(static_cast<int>(i)));
+        inserted.insert(i);
+    }
+    vector<int64_t> keys;
+    for (int64_t i = 0; i < 2000; ++i) keys.push_back(i);
+    auto out = make_unique<bool[]>(keys.size());
+    ht.containsMany(keys, {out.get(), keys.size()});
+    for (size_t i = 0; i < keys.size(); ++i) EXPECT_EQ(out[i], inserted.contains(keys[i])) << keys[i];
+
+    EXPECT_THROW(ht.containsMany(keys, {out.get(), keys.size() - 1}), invalid_argument);
+    ChainingHashTable moved(std::move(ht));
+    ht.containsMany(keys, {out.get(), keys.size()});
+    EXPECT_EQ(count(out.get(), out.get() + keys.size(), true), 0);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, FindMany) {
+    BasicChainingHashTable<int64_t, int64_t> ht;
+    for (int64_t i = 0; i < 1000; ++i) ht.insert(i << 10, i);
+    vector<int64_t> keys = {0, 1, 5 << 10, 999 << 10, 1000 << 10, 5 << 10};
+    vector<int64_t*> out(keys.size());
+    ht.findMany(keys, out);
+    EXPECT_EQ(out[0], &ht[0]);
+    EXPECT_EQ(out[1], nullptr);
+    EXPECT_EQ(*out[2], 5);
+    EXPECT_EQ(*out[3], 999);
+    EXPECT_EQ(out[4], nullptr);
+    EXPECT_EQ(out[5], out[2]);
+
+    ht.findMany({}, {});
+    vector<int64_t*> tooShort(keys.size() - 1);
+    EXPECT_THROW(ht.findMany(keys, tooShort), invalid_argument);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, SaveAndOpenMapped) {
+    TempFile file("image");
+    {
+        ChainingHashTable ht(ChainingHashTable::RehashMode::Incremental);
+        for (int i = 0; i < 10000; ++i) ht.insert(i * 7, GV(i));
+        for (int i = 0; i < 10000; i += 3) ht.erase(i * 7);
+        ht.save(file.path);
+    }
+    auto ht = ChainingHashTable::openMapped(file.path);
+    EXPECT_EQ(ht.size(), 6666);
+    for (int i = 0; i < 10000; ++i) {
+        SCOPED_TRACE(i);
+        ASSERT_EQ(ht.contains(i * 7), i % 3 != 0);
+        if (i % 3) {
+            EXPECT_EQ(asInt(ht.find(i * 7)->value), i);
+        }
+    }
+    EXPECT_FALSE(ht.contains(1));
+
+    size_t count = 0;
+    for (auto& entry : ht) {
+        EXPECT_EQ(asInt(entry.value), entry.key / 7);
+        ++count;
+    }
+    EXPECT_EQ(count, 6666);
+
+    vector<int64_t> keys = {7, 14, 21, 1};
+    vector<GenericValue*> out(keys.size());
+    ht.findMany(keys, out);
+    EXPECT_EQ(asInt(*out[0]), 1);
+    EXPECT_EQ(asInt(*out[1]), 2);
+    EXPECT_EQ(out[2], nullptr);
+    EXPECT_EQ(out[3], nullptr);
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, IterateFromFindOnMappedTable) {
+    TempFile file("find_iterate");
+    {
+        BasicChainingHashTable<int64_t, int64_t> ht;
+        for (int64_t i = 0; i < 100; ++i) ht.insert(i, i);
+        ht.save(file.path);
+    }
+    auto ht = BasicChainingHashTable<int64_t, int64_t>::openMapped(file.path);
+    ht.insert(1000, 1000);
+    EXPECT_EQ(distance(ht.begin(), ht.end()), 101);
+    // the regular entries come first, the mapped ones after them
+    EXPECT_EQ(distance(ht.find(1000), ht.end()), 101);
+    set<int64_t> rest;
+    for (auto it = ht.find(50); it != ht.end(); ++it) rest.insert(it->key);
+    EXPECT_TRUE(rest.contains(50));
+    EXPECT_FALSE(rest.contains(1000));
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, MappedWritesAreCopyOnWrite) {
+    TempFile file("cow");
+    TempFile resaved("cow_resaved");
+    {
+        BasicChainingHashTable<int64_t, int64_t> ht;
+        for (int64_t i = 0; i < 1000; ++i) ht.insert(i, i);
+        ht.save(file.path);
+    }
+    {
+        auto ht = BasicChainingHashTable<int64_t, int64_t>::openMapped(file.path);
+        int64_t* mapped = &ht[5];
+        ht.insert(5, 50);
+        ht[6] = 60;
+        ht.erase(7);
+        ht.erase(7);
+        ht.insert(1000, 1000);
+        for (int64_t i = 1001; i < 2000; ++i) ht.insert(i, i);
+        EXPECT_EQ(mapped, &ht[5]);
+        EXPECT_EQ(ht[5], 50);
+        EXPECT_EQ(ht[6], 60);
+        EXPECT_FALSE(ht.contains(7));
+        EXPECT_EQ(ht.size(), 1999);
+
+        // erased mapped keys come back as regular entries
+        ht.insert(7, 70);
+        EXPECT_EQ(ht[7], 70);
+        EXPECT_EQ(ht.size(), 2000);
+
+        // erase while iterating over both regular and mapped entries
+        for (auto it = ht.begin(); it != ht.end();) {
+            int64_t key = (it++)->key;
+            if (key % 2) ht.erase(key);
+        }
+        EXPECT_EQ(ht.size(), 1000);
+        for (auto& entry : ht) EXPECT_EQ(entry.key % 2, 0);
+
+        ht.save(resaved.path);
+        BasicChainingHashTable<int64_t, int64_t> moved(std::move(ht));
+        EXPECT_EQ(moved.size(), 1000);
+        EXPECT_FALSE(ht.contains(6));
+        EXPECT_EQ(ht.begin(), ht.end());
+    }
+
+    // the first image is unchanged
+    auto original = BasicChainingHashTable<int64_t, int64_t>::openMapped(file.path);
+    EXPECT_EQ(original.size(), 1000);
+    EXPECT_EQ(original[5], 5);
+    EXPECT_EQ(original[7], 7);
+    EXPECT_FALSE(original.contains(1000));
+
+    auto reopened = BasicChainingHashTable<int64_t, int64_t>::openMapped(resaved.path);
+    EXPECT_EQ(reopened.size(), 1000);
+    EXPECT_EQ(reopened[6], 60);
+    EXPECT_EQ(reopened[1998], 1998);
+    EXPECT_FALSE(reopened.contains(5));
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, OpenMappedRejectsOtherFiles) {
+    TempFile file("invalid");
+    EXPECT_THROW(ChainingHashTable::openMapped(file.path), runtime_error);
+    {
+        ofstream out(file.path, ios::binary);
+        out << "not a hash table image, but long enough to have a header";
+    }
+    EXPECT_THROW(ChainingHashTable::openMapped(file.path), runtime_error);
+
+    BasicChainingHashTable<int64_t, int64_t> ht;
+    for (int64_t i = 0; i < 100; ++i) ht.insert(i, i);
+    ht.save(file.path);
+    // another value type
+    EXPECT_THROW(ChainingHashTable::openMapped(file.path), runtime_error);
+    filesystem::resize_file(file.path, filesystem::file_size(file.path) - 1);
+    EXPECT_THROW((BasicChainingHashTable<int64_t, int64_t>::openMapped(file.path)), runtime_error);
+
+    // an empty table still has a valid image
+    BasicChainingHashTable<int64_t, int64_t>().save(file.path);
+    auto empty = BasicChainingHashTable<int64_t, int64_t>::openMapped(file.path);
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, Stats) {
+    BasicChainingHashTable<int64_t, int64_t> ht;
+    auto empty = ht.stats();
+    EXPECT_EQ(empty.entries, 0);
+    EXPECT_EQ(empty.bucketCount, 16);
+    EXPECT_EQ(empty.chainLengths, vector<size_t>{16});
+    EXPECT_EQ(empty.rehashes, 0);
+    EXPECT_EQ(empty.averageProbeLength, 0.0);
+
+    for (int64_t i = 0; i < 1000; ++i) ht.insert(i, i);
+    for (int64_t i = 0; i < 1000; ++i) ht.find(i);
+    auto stats = ht.stats();
+    EXPECT_EQ(stats.entries, 1000);
+    EXPECT_EQ(stats.bucketCount, 2048);
+    EXPECT_DOUBLE_EQ(stats.loadFactor, 1000.0 / 2048);
+    EXPECT_EQ(stats.sampledBuckets, 2048);
+    size_t buckets = 0, entries = 0;
+    for (size_t length = 0; length < stats.chainLengths.size(); ++length) {
+        buckets += stats.chainLengths[length];
+        entries += length * stats.chainLengths[length];
+    }
+    EXPECT_EQ(buckets, 2048);
+    EXPECT_EQ(entries, 1000);
+    EXPECT_GE(stats.bucketBytes, 2048 * sizeof(void*));
+    EXPECT_EQ(stats.nodeBytes, 1000 * sizeof(BasicChainingHashTable<int64_t, int64_t>::Entry));
+    EXPECT_EQ(stats.valueBytes, 1000 * sizeof(int64_t));
+    EXPECT_EQ(stats.mappedEntries, 0);
+    if (stats.instrumented) {
+        // 16 buckets doubled up to 2048
+        EXPECT_EQ(stats.rehashes, 7);
+        EXPECT_GE(stats.averageProbeLength, 1.0);
+    } else {
+        EXPECT_EQ(stats.rehashes, 0);
+        EXPECT_EQ(stats.averageProbeLength, 0.0);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestChainingHashTable, StatsSampleLargeTables) {
+    BasicChainingHashTable<int64_t, int64_t> ht(BasicChainingHashTable<int64_t, int64_t>::RehashMode::Incremental);
+    for (int64_t i = 0; i < 100000; ++i) ht.insert(i, i);
+    auto stats = ht.stats();
+    EXPECT_EQ(stats.bucketCount, 262144);
+    EXPECT_LE(stats.sampledBuckets, detail::STATS_SAMPLE_BUCKETS);
+    EXPECT_GE(stats.sampledBuckets, detail::STATS_SAMPLE_BUCKETS / 2);
+    size_t sampled = 0;
+    for (size_t count : stats.chainLengths) sampled += count;
+    EXPECT_EQ(sampled, stats.sampledBuckets);
+
+    TempFile file("stats");
+    ht.save(file.path);
+    auto mapped = BasicChainingHashTable<int64_t, int64_t>::openMapped(file.path);
+    mapped.erase(1);
+    auto mappedStats = mapped.stats();
+    EXPECT_EQ(mappedStats.entries, 99999);
+    EXPECT_EQ(mappedStats.mappedEntries, 99999);
+    EXPECT_EQ(mappedStats.mappedBytes, filesystem::file_size(file.path));
+    EXPECT_EQ(mappedStats.nodeBytes, 0);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,157 @@
+#include "lib/ConcurrentChainingHashTable.hpp"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace hashtable;
+using namespace std;
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+// A value that fills all 64 bytes with the same number, so that a torn
+// read shows up as differing words
+GenericValue filled(int64_t i) {
+    GenericValue value;
+    array<int64_t, 8> words;
+    words.fill(i);
+    memcpy(value.getData(), words.data(), sizeof(words));
+    return value;
+}
+//---------------------------------------------------------------------------
+// The number in a filled value, -1 if the words differ
+int64_t numberOf(const GenericValue& value) {
+    array<int64_t, 8> words;
+    memcpy(words.data(), value.getData(), sizeof(words));
+    for (int64_t word : words)
+        if (word != words[0]) return -1;
+    return words[0];
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(TestConcurrentChainingHashTable, ShardCount) {
+    EXPECT_EQ(ConcurrentChainingHashTable().shardCount(), ConcurrentChainingHashTable::DEFAULT_SHARDS);
+    EXPECT_EQ(ConcurrentChainingHashTable(5).shardCount(), 8);
+    EXPECT_EQ(ConcurrentChainingHashTable(0).shardCount(), 1);
+}
+//---------------------------------------------------------------------------
+TEST(TestConcurrentChainingHashTable, InsertFindErase) {
+    for (size_t shards : {1, 64}) {
+        SCOPED_TRACE(shards);
+        ConcurrentChainingHashTable ht(shards);
+        EXPECT_EQ(ht.size(), 0);
+        EXPECT_FALSE(ht.contains(1));
+        EXPECT_FALSE(ht.erase(1));
+
+        for (int64_t i = 0; i < 10000; ++i) EXPECT_TRUE(ht.insert(i * 7, filled(i)));
+        EXPECT_FALSE(ht.insert(7, filled(42)));
+        EXPECT_EQ(ht.size(), 10000);
+
+        GenericValue value;
+        EXPECT_TRUE(ht.find(7, value));
+        EXPECT_EQ(numberOf(value), 42);
+        EXPECT_FALSE(ht.find(8, value));
+        EXPECT_EQ(numberOf(value), 42);
+
+        for (int64_t i = 0; i < 10000; i += 2) EXPECT_TRUE(ht.erase(i * 7));
+        EXPECT_EQ(ht.size(), 5000);
+        for (int64_t i = 2; i < 10000; ++i) {
+            ASSERT_EQ(ht.find(i * 7, value), i % 2 == 1);
+            if (i % 2) {
+                EXPECT_EQ(numberOf(value), i);
+            }
+        }
+
+        // erased nodes are reused
+        for (int64_t i = 0; i < 10000; i += 2) EXPECT_TRUE(ht.insert(i * 7 + 1, filled(-i)));
+        EXPECT_EQ(ht.size(), 10000);
+        EXPECT_TRUE(ht.find(4 * 7 + 1, value));
+        EXPECT_EQ(numberOf(value), -4);
+        EXPECT_FALSE(ht.contains(4 * 7));
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestConcurrentChainingHashTable, PlainValues) {
+    BasicConcurrentChainingHashTable<int64_t, int64_t> ht(4);
+    const int64_t one = 1;
+    ht.insert(1, one);
+    ht.insert(2, 2);
+    int64_t value = 0;
+    EXPECT_TRUE(ht.find(1, value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(ht.find(2, value));
+    EXPECT_EQ(value, 2);
+}
+//---------------------------------------------------------------------------
+TEST(TestConcurrentChainingHashTable, ConcurrentInserts) {
+    ConcurrentChainingHashTable ht(16);
+    constexpr int64_t perThread = 20000;
+    {
+        vector<jthread> threads;
+        for (int64_t t = 0; t < 8; ++t) {
+            threads.emplace_back([&ht, t] {
+                for (int64_t i = t * perThread; i < (t + 1) * perThread; ++i) ht.insert(i, filled(i));
+            });
+        }
+    }
+    EXPECT_EQ(ht.size(), 8 * perThread);
+    GenericValue value;
+    for (int64_t i = 0; i < 8 * perThread; ++i) {
+        ASSERT_TRUE(ht.find(i, value)) << i;
+        ASSERT_EQ(numberOf(value), i);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestConcurrentChainingHashTable, ReadersDuringWrites) {
+    // few shards, so that readers and writers meet a lot
+    ConcurrentChainingHashTable ht(4);
+    // [0, 1000) stay in the table and get new values, [1000, 2000) come and
+    // go, and keys from 10000 on are added for good, so that the shards grow
+    // again and again while the readers run
+    constexpr int64_t rounds = 50;
+    constexpr int64_t addedPerRound = 500;
+    for (int64_t i = 0; i < 1000; ++i) ht.insert(i, filled(i));
+
+    atomic<bool> done = false;
+    atomic<int64_t> errors = 0;
+    {
+        vector<jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                GenericValue value;
+                while (!done.load()) {
+                    for (int64_t i = 0; i < 2000; ++i) {
+                        bool found = ht.find(i, value);
+                        // values are i or i + 1000000 * round, never torn
+                        if ((i < 1000 && !found) || (found && (numberOf(value) < 0 || numberOf(value) % 1000000 != i))) ++errors;
+                    }
+                }
+            });
+        }
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&, t] {
+                int64_t added = 10000 + t * rounds * addedPerRound;
+                for (int64_t round = 1; round <= rounds; ++round) {
+                    for (int64_t i = t; i < 1000; i += 2) ht.insert(i, filled(i + 1000000 * round));
+                    for (int64_t i = 1000 + t; i < 2000; i += 2) ht.insert(i, filled(i + 1000000 * round));
+                    for (int64_t i = 0; i < addedPerRound; ++i, ++added) ht.insert(added, filled(added));
+                    for (int64_t i = 1000 + t; i < 2000; i += 2) ht.erase(i);
+                }
+            });
+        }
+        threads[5].join();
+        threads[4].join();
+        done = true;
+    }
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(ht.size(), 1000 + 2 * rounds * addedPerRound);
+    GenericValue value;
+    for (int64_t i = 10000; i < 10000 + 2 * rounds * addedPerRound; ++i) {
+        ASSERT_TRUE(ht.find(i, value)) << i;
+        ASSERT_EQ(numberOf(value), i);
+    }
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,175 @@
+#include "lib/DenseHashTable.hpp"
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace hashtable;
+using namespace std;
+//---------------------------------------------------------------------------
+static GenericValue GV(int i) {
+    GenericValue value;
+    memcpy(value.getData(), &i, sizeof(i));
+    return value;
+}
+//---------------------------------------------------------------------------
+static int asInt(const GenericValue& gv) {
+    int value;
+    memcpy(&value, gv.getData(), sizeof(value));
+    return value;
+}
+//---------------------------------------------------------------------------
+static vector<int64_t> keysOf(BasicDenseHashTable<int64_t, int64_t>& ht) {
+    vector<int64_t> keys;
+    for (auto& entry : ht) keys.push_back(entry.key);
+    return keys;
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, EntryKeyIsConst) {
+    ASSERT_TRUE(is_const_v<decltype(DenseHashTable::Entry::key)>);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, IteratorConcept) {
+    EXPECT_TRUE(forward_iterator<DenseHashTable::iterator>);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, ConstructEmpty) {
+    DenseHashTable ht;
+    EXPECT_EQ(ht.size(), 0);
+    EXPECT_FALSE(ht.contains(0));
+    EXPECT_EQ(ht.begin(), ht.end());
+    EXPECT_EQ(ht.find(0), ht.end());
+    ht.erase(0);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, InsertLookup) {
+    DenseHashTable ht;
+    ht.insert(123, GV(456));
+    EXPECT_EQ(ht.size(), 1);
+    EXPECT_TRUE(ht.contains(123));
+    EXPECT_EQ(asInt(ht[123]), 456);
+
+    ht.insert(123, GV(789));
+    EXPECT_EQ(ht.size(), 1);
+    EXPECT_EQ(asInt(ht[123]), 789);
+
+    ht[234] = GV(567);
+    EXPECT_EQ(ht.size(), 2);
+    EXPECT_EQ(asInt(ht.find(234)->value), 567);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, InsertMany) {
+    DenseHashTable ht;
+    for (int i = 0; i < 10000; ++i) ht.insert((i + 43) * 1327, GV(i));
+    EXPECT_EQ(ht.size(), 10000);
+    for (int i = 0; i < 10000; ++i) {
+        SCOPED_TRACE(i);
+        EXPECT_TRUE(ht.contains((i + 43) * 1327));
+        EXPECT_EQ(asInt(ht[(i + 43) * 1327]), i);
+    }
+    EXPECT_FALSE(ht.contains(42));
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, IterationIsInsertionOrder) {
+    BasicDenseHashTable<int64_t, int64_t> ht;
+    vector<int64_t> expected;
+    for (int64_t i = 0; i < 1000; ++i) {
+        int64_t key = (i * 7919) % 1009;
+        ht.insert(key, i);
+        expected.push_back(key);
+    }
+    EXPECT_EQ(keysOf(ht), expected);
+
+    // overwriting keeps the position
+    ht.insert(expected[10], 0);
+    EXPECT_EQ(keysOf(ht), expected);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, EraseLeavesHoles) {
+    BasicDenseHashTable<int64_t, int64_t> ht;
+    for (int64_t i = 0; i < 100; ++i) ht.insert(i, i);
+    vector<int64_t> expected;
+    for (int64_t i = 0; i < 100; ++i) {
+        if (i % 3 == 0)
+            ht.erase(i);
+        else
+            expected.push_back(i);
+    }
+    EXPECT_EQ(ht.size(), expected.size());
+    EXPECT_EQ(ht.holes(), 34);
+    EXPECT_EQ(keysOf(ht), expected);
+    for (int64_t i = 0; i < 100; ++i) EXPECT_EQ(ht.contains(i), i % 3 != 0);
+
+    ht.compact();
+    EXPECT_EQ(ht.holes(), 0);
+    EXPECT_EQ(keysOf(ht), expected);
+    for (int64_t key : expected) EXPECT_EQ(ht[key], key);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, HolesAreCompactedOnGrowth) {
+    BasicDenseHashTable<int64_t, int64_t> ht;
+    for (int64_t round = 0; round < 100; ++round) {
+        for (int64_t i = 0; i < 100; ++i) ht.insert(round * 100 + i, i);
+        for (int64_t i = 0; i < 100; ++i)
+            if (i != 0) ht.erase(round * 100 + i);
+        // the array only grows if less than a quarter of it are holes, so
+        // it stays below 8/3 of the largest number of live entries
+        ASSERT_LE(ht.holes(), 3 * (ht.size() + 100));
+    }
+    EXPECT_EQ(ht.size(), 100);
+    vector<int64_t> expected;
+    for (int64_t round = 0; round < 100; ++round) expected.push_back(round * 100);
+    EXPECT_EQ(keysOf(ht), expected);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, EraseDuringIteration) {
+    BasicDenseHashTable<int64_t, int64_t> ht;
+    for (int64_t i = 0; i < 1000; ++i) ht.insert(i, i);
+    for (auto it = ht.begin(); it != ht.end();) {
+        int64_t key = (it++)->key;
+        if (key % 2) ht.erase(key);
+    }
+    EXPECT_EQ(ht.size(), 500);
+    for (auto& entry : ht) EXPECT_EQ(entry.key % 2, 0);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, StringKeys) {
+    BasicDenseHashTable<string, string> ht;
+    for (int i = 0; i < 1000; ++i) ht.insert("key" + to_string(i), to_string(i));
+    for (int i = 0; i < 1000; i += 2) ht.erase("key" + to_string(i));
+    ht.compact();
+    EXPECT_EQ(ht.size(), 500);
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(ht.contains("key" + to_string(i)), i % 2 == 1);
+    EXPECT_EQ(ht["key999"], "999");
+    const string value = "x";
+    ht.insert("key999", value);
+    EXPECT_EQ(ht.find("key999")->value, "x");
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, Move) {
+    DenseHashTable ht;
+    for (int i = 0; i < 100; ++i) ht.insert(i, GV(i));
+    DenseHashTable moved(std::move(ht));
+    EXPECT_EQ(moved.size(), 100);
+    EXPECT_EQ(asInt(moved[42]), 42);
+
+    ht = std::move(moved);
+    EXPECT_EQ(ht.size(), 100);
+    EXPECT_EQ(asInt(ht[42]), 42);
+    moved.insert(1, GV(1));
+    EXPECT_EQ(moved.size(), 1);
+}
+//---------------------------------------------------------------------------
+TEST(TestDenseHashTable, Reserve) {
+    BasicDenseHashTable<int64_t, int64_t> ht;
+    ht.insert(1, 1);
+    ht.reserve(1000);
+    int64_t* first = &ht[1];
+    for (int64_t i = 2; i <= 1000; ++i) ht.insert(i, i);
+    // no growth, so the value did not move
+    EXPECT_EQ(first, &ht[1]);
+}
+//---------------------------------------------------------------------------
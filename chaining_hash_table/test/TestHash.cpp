@@ -0,0 +1,42 @@
+#include "lib/ChainingHashTable.hpp"
+#include "lib/Hash.hpp"
+#include <functional>
+#include <set>
+#include <string>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace hashtable;
+using namespace std;
+//---------------------------------------------------------------------------
+TEST(TestHash, HasherConcept) {
+    EXPECT_TRUE(KeyHasher<MixHash>);
+    EXPECT_TRUE(KeyHasher<std::hash<int64_t>>);
+    EXPECT_FALSE(KeyHasher<int>);
+    EXPECT_TRUE((KeyHasher<DefaultHash<string>, string>));
+    EXPECT_FALSE((KeyHasher<MixHash, string>));
+}
+//---------------------------------------------------------------------------
+TEST(TestHash, DefaultHashMixesIntegers) {
+    for (int64_t key : {0l, 1l, -1l, 1l << 40}) EXPECT_EQ(DefaultHash<int64_t>{}(key), MixHash{}(key));
+}
+//---------------------------------------------------------------------------
+TEST(TestHash, StridedKeysSpreadOverLowBits) {
+    // 1024 keys into 1024 buckets: random placement fills about 63% of them
+    for (int shift : {0, 10, 20, 32, 40, 50}) {
+        SCOPED_TRACE(shift);
+        set<uint64_t> buckets;
+        for (int64_t i = 0; i < 1024; ++i) buckets.insert(MixHash{}(i << shift) & 1023);
+        EXPECT_GT(buckets.size(), 600);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestHash, CustomHasher) {
+    BasicChainingHashTable<int64_t, GenericValue, std::hash<int64_t>> ht;
+    for (int64_t i = 0; i < 1000; ++i) ht.insert(i << 10, GenericValue());
+    EXPECT_EQ(ht.size(), 1000);
+    for (int64_t i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(ht.contains(i << 10));
+        EXPECT_FALSE(ht.contains((i << 10) + 1));
+    }
+}
+//---------------------------------------------------------------------------
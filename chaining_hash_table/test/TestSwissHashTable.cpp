@@ -0,0 +1,176 @@
+#include "lib/SwissHashTable.hpp"
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+using namespace hashtable;
+using namespace std;
+//---------------------------------------------------------------------------
+static GenericValue GV(int i) {
+    GenericValue value;
+    memcpy(value.getData(), &i, sizeof(i));
+    return value;
+}
+//---------------------------------------------------------------------------
+static int asInt(const GenericValue& gv) {
+    int value;
+    memcpy(&value, gv.getData(), sizeof(value));
+    return value;
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, EntryKeyIsConst) {
+    ASSERT_TRUE(is_const_v<decltype(SwissHashTable::Entry::key)>);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, ConstructEmpty) {
+    SwissHashTable ht;
+    EXPECT_EQ(ht.size(), 0);
+    EXPECT_FALSE(ht.contains(0));
+    EXPECT_EQ(ht.begin(), ht.end());
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, InsertLookup) {
+    SwissHashTable ht;
+    ht.insert(123, GV(456));
+    EXPECT_EQ(ht.size(), 1);
+    EXPECT_TRUE(ht.contains(123));
+    EXPECT_EQ(asInt(ht[123]), 456);
+
+    ht.insert(123, GV(789));
+    EXPECT_EQ(ht.size(), 1);
+    EXPECT_EQ(asInt(ht[123]), 789);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, SubscriptInsert) {
+    SwissHashTable ht;
+    ht[123] = GV(456);
+    ht[234] = GV(567);
+    EXPECT_EQ(ht.size(), 2);
+    ht[123] = GV(789);
+    EXPECT_EQ(ht.size(), 2);
+    EXPECT_EQ(asInt(ht[123]), 789);
+    EXPECT_EQ(asInt(ht[234]), 567);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, InsertManyGrowsPowerOfTwo) {
+    SwissHashTable ht;
+    for (int i = 0; i < 10000; ++i) {
+        int value = (i + 43) * 1327;
+        ht.insert(value, GV(i));
+        ASSERT_EQ(ht.size(), i + 1);
+        ASSERT_TRUE(has_single_bit(ht.capacity()));
+        ASSERT_LE(ht.size() * 8, ht.capacity() * 7);
+    }
+    for (int i = 0; i < 10000; ++i) {
+        SCOPED_TRACE(i);
+        int value = (i + 43) * 1327;
+        EXPECT_TRUE(ht.contains(value));
+        EXPECT_EQ(asInt(ht[value]), i);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, StridedKeys) {
+    SwissHashTable ht;
+    for (int64_t i = 0; i < 5000; ++i) ht.insert(i << 20, GV(static_cast<int>(i)));
+    for (int64_t i = 0; i < 5000; ++i) {
+        ASSERT_TRUE(ht.contains(i << 20));
+        ASSERT_FALSE(ht.contains((i << 20) + 1));
+    }
+    EXPECT_LE(ht.capacity(), 8192);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, InsertErase) {
+    SwissHashTable ht;
+    for (int i = 0; i < 100; ++i) ht.insert(i, GV(i));
+    for (int i = 0; i < 100; ++i) {
+        SCOPED_TRACE(i);
+        EXPECT_TRUE(ht.contains(i));
+        ht.erase(i);
+        EXPECT_FALSE(ht.contains(i));
+        EXPECT_EQ(ht.size(), 100 - i - 1);
+        // Erasing must not hide keys that probed past the erased slot
+        for (int j = i + 1; j < 100; ++j) ASSERT_TRUE(ht.contains(j));
+    }
+    ht.erase(1000);
+    EXPECT_EQ(ht.size(), 0);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, TombstonesAreReused) {
+    SwissHashTable ht;
+    for (int i = 0; i < 1000; ++i) ht.insert(i, GV(i));
+    size_t capacity = ht.capacity();
+    // Churn with a constant number of live entries must not grow the table
+    for (int i = 1000; i < 100000; ++i) {
+        ht.erase(i - 1000);
+        ht.insert(i, GV(i));
+    }
+    EXPECT_EQ(ht.size(), 1000);
+    EXPECT_EQ(ht.capacity(), capacity);
+    for (int i = 99000; i < 100000; ++i) ASSERT_EQ(asInt(ht[i]), i);
+    EXPECT_EQ(ht.size(), 1000);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, Move) {
+    SwissHashTable ht1;
+    ht1.insert(123, GV(456));
+    ht1.insert(234, GV(567));
+
+    SwissHashTable ht2(std::move(ht1));
+    EXPECT_EQ(ht2.size(), 2);
+    EXPECT_TRUE(ht2.contains(123));
+    EXPECT_TRUE(ht2.contains(234));
+
+    SwissHashTable ht3;
+    ht3.insert(1, GV(1));
+    ht3 = std::move(ht2);
+    EXPECT_EQ(ht3.size(), 2);
+    EXPECT_FALSE(ht3.contains(1));
+    EXPECT_EQ(asInt(ht3[234]), 567);
+
+    // A moved-from table is empty and usable
+    EXPECT_FALSE(ht2.contains(123));
+    EXPECT_EQ(ht2.begin(), ht2.end());
+    ht2.insert(5, GV(6));
+    EXPECT_EQ(asInt(ht2[5]), 6);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, IteratorConcept) {
+    ASSERT_TRUE(forward_iterator<SwissHashTable::iterator>);
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, Iterators) {
+    SwissHashTable ht;
+    for (int i = 0; i < 1000; ++i) ht.insert(i, GV(i + 100));
+    for (int i = 0; i < 1000; i += 3) ht.erase(i);
+
+    set<int64_t> seen;
+    for (auto it = ht.begin(); it != ht.end(); it++) {
+        EXPECT_EQ(asInt(it->value), it->key + 100);
+        EXPECT_NE(it->key % 3, 0);
+        seen.insert((*it).key);
+    }
+    EXPECT_EQ(seen.size(), ht.size());
+}
+//---------------------------------------------------------------------------
+TEST(TestSwissHashTable, Find) {
+    SwissHashTable ht;
+    EXPECT_EQ(ht.find(123), ht.end());
+    for (int i = 0; i < 100; ++i) ht.insert(i, GV(i + 100));
+    EXPECT_EQ(ht.find(123), ht.end());
+    for (int i = 0; i < 100; ++i) {
+        SCOPED_TRACE(i);
+        auto it = ht.find(i);
+        EXPECT_EQ(it->key, i);
+        EXPECT_EQ(asInt(it->value), i + 100);
+    }
+    for (int i = 0; i < 100; ++i) {
+        ht.erase(i);
+        EXPECT_EQ(ht.find(i), ht.end());
+    }
+}
+//---------------------------------------------------------------------------